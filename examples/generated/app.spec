@@ -0,0 +1,10 @@
+# The same arguments as in 'abstract' example, known at build time
+workspace "USAGE: app [-OPTIONS] arg1 arg2\nOR: app arg1 arg2 [-OPTIONS]" "App for testing 'scmdpgen' generator.\nIt shows functionality for group\nof some abstract options"
+
+help --help -h
+
+opt --option1 -op1 VALUE "Optional argument 1\nwith value"
+opt --option2 -op2 "" "Optional argument 2\nwithout value"
+
+nonopt arg1 "Neccessary argument 1\nOther description"
+nonopt arg2 "Neccessary argument 2"
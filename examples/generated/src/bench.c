@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <scmdp.h>
+#include "app_args.h"
+
+/* The same command line for every parser */
+static char *benchArgv[] = {"app", "--option1", "value", "-op2", "first", "second", NULL};
+static int benchArgc = 6;
+
+static double Now(void)
+{
+    struct timespec now;
+
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/* Workspace of 'abstract' example, the same as app.spec */
+static void AddAppArgs(ScmdpWorkspace *workspace, char **op1, char **op2, char **arg1, char **arg2)
+{
+    *workspace = AddWorkspace("USAGE: app [-OPTIONS] arg1 arg2\nOR: app arg1 arg2 [-OPTIONS]",
+                              "App for testing 'scmdp' library.\nIt shows functionality for group\nof some abstract options");
+    AddHelpArg(workspace, "--help", "-h");
+    AddOptArg(workspace, "--option1", "-op1", "Optional argument 1\nwith value", "VALUE", op1);
+    AddOptArg(workspace, "--option2", "-op2", "Optional argument 2\nwithout value", "", op2);
+    AddNonOptArg(workspace, "arg1", "Neccessary argument 1\nOther description", arg1);
+    AddNonOptArg(workspace, "arg2", "Neccessary argument 2", arg2);
+}
+
+int main(int argc, char* argv[])
+{
+    /* Number of parses may be given by the first argument */
+    long iterations = (argc > 1) ? atol(argv[1]) : 1000000;
+    long parsed = 0;
+    double start;
+    char *op1, *op2, *arg1, *arg2;
+    ScmdpWorkspace workspace;
+    ScmdpParseContext context;
+
+    if (iterations <= 0)
+    {
+        printf("USAGE: bench [ITERATIONS]\n");
+        return 1;
+    }
+
+    /* Generated parser matches keys known at build time */
+    start = Now();
+    for (long i = 0; i < iterations; i++)
+    {
+        AppArgs args = {NULL, false, NULL, NULL};
+
+        parsed += AppParseArgs(&args, benchArgc, benchArgv) && args.option2;
+    }
+    printf("generated:          %8.1f ns per parse\n", (Now() - start) / iterations);
+
+    /* ParseArgs() releases the workspace, so a program builds it for every run */
+    start = Now();
+    for (long i = 0; i < iterations; i++)
+    {
+        op1 = op2 = NULL;
+        AddAppArgs(&workspace, &op1, &op2, &arg1, &arg2);
+        parsed += ParseArgs(&workspace, benchArgc, benchArgv) && op2 != NULL;
+    }
+    printf("ParseArgs:          %8.1f ns per parse\n", (Now() - start) / iterations);
+
+    /* Compiled workspace and context are reused, only parsing is timed */
+    AddAppArgs(&workspace, &op1, &op2, &arg1, &arg2);
+    context = AddParseContext(&workspace);
+    start = Now();
+    for (long i = 0; i < iterations; i++)
+    {
+        op2 = NULL;
+        parsed += ParseArgsInContext(&workspace, &context, benchArgc, benchArgv) && op2 != NULL;
+    }
+    printf("ParseArgsInContext: %8.1f ns per parse\n", (Now() - start) / iterations);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+
+    return (parsed == 3 * iterations) ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#include <stdio.h>
+#include "app_args.h"
+
+int main(int argc, char* argv[])
+{
+    /* Structure to drop argument values, generated from app.spec */
+    AppArgs args = {NULL, false, NULL, NULL};
+
+    /* If the parsing fails, then exit the program */
+    if (!AppParseArgs(&args, argc, argv)) return 0;
+
+    /* Body of program */
+    printf(">>CMD_VALS:\n-op1: %s\n-op2: %s\narg1: %s\narg2: %s", args.option1, args.option2 ? "true" : "(null)", args.arg1, args.arg2);
+
+    return 0;
+}
@@ -5,14 +5,68 @@
 #include <malloc.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+/* Functions of library have C linkage, so it can be used from C++ (see scmdp.hpp) */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*  Codes of errors */
+#define ERR_NONE -1
 #define ERR_UNKNOWN_PARAMETER 0
 #define ERR_NO_VAL_OPT_PARAMETER 1
 #define ERR_NO_VAL_NOPT_PARAMETER 2
 #define ERR_WRONG_PARS_NUMBER 3
 #define ERR_WRONG_SYNTAX 4
+#define ERR_REQUIRED_OPTION 5
+#define ERR_CONFLICTING_OPTIONS 6
+#define ERR_NO_OPTION_OF_GROUP 7
+#define ERR_REJECTED_VALUE 8
+#define ERR_WRONG_NUMBER 9
+#define ERR_OVER_BUDGET 10
+#define ERR_NO_FILE 11
+#define ERR_REPEATED_KEY 12
+#define ERR_UNKNOWN_CONSTRAINT_KEY 13
+#define ERR_TOO_LONG_KEY 14
+
+/* Kinds of constraints between optional arguments */
+#define SCMDP_REQUIRES 0
+#define SCMDP_CONFLICTS 1
+#define SCMDP_ONE_OF 2
+
+/* Size of console line buffer and maximal number of words in console line */
+#define SCMDP_LINE_SIZE 4096
+#define SCMDP_MAX_TOKENS 256
+
+/* Identifier of the help argument in the key index (optional arguments use their position) */
+#define SCMDP_HELP_ID -1
+
+/* Types of values of optional arguments (see SetOptType()) */
+#define SCMDP_TYPE_TEXT 0
+#define SCMDP_TYPE_INT_LIST 1
+#define SCMDP_TYPE_RANGE_LIST 2
+#define SCMDP_TYPE_SIZE 3
+#define SCMDP_TYPE_DURATION 4
+
+/* Maximal number of numbers of all typed values of one parsing */
+#define SCMDP_MAX_NUMBERS 1048576
+
+/* Maximal number of keys suggested for unknown argument */
+#define SCMDP_MAX_SUGGESTIONS 3
+
+/* Number of keys in the cache of the most used keys (see EnableHotKeyCache()) */
+#define SCMDP_HOT_CACHE_SIZE 16
+
+/* Syntax profiles for SetSyntaxProfile(): prefixes, value separators, case folding, '--' terminator */
+#define SCMDP_SYNTAX_DEFAULT {"-/", "", false, true}
+#define SCMDP_SYNTAX_POSIX {"-", "=", false, true}
+#define SCMDP_SYNTAX_WINDOWS {"/", ":", true, false}
+
+/* Formats of parse result (see FormatParseResult()) */
+#define SCMDP_FORMAT_JSON 0
+#define SCMDP_FORMAT_NDJSON 1
 
 /* Structure of optional argument */
 typedef struct
@@ -40,6 +94,159 @@ typedef struct
     char *shortHelpKey; /* Short parameter (ex.: -h) */
 } ScmdpHelpArg;
 
+/* Structure of variadic non-optional argument taking all remaining non-optional values */
+typedef struct
+{
+    char *key; /* The name of parameter (ex.: FILE) */
+    char *help; /* Description of parameter */
+    int minCount; /* Minimal number of values */
+    int maxCount; /* Maximal number of values, -1 if it's unlimited */
+    char ***valPlace; /* Pointer of variable to write the pointer to the first value inside argv */
+    int *countPlace; /* Pointer of variable to write the number of values */
+} ScmdpRestArg;
+
+/* Declared constraint between two optional arguments */
+typedef struct
+{
+    int kind; /* SCMDP_REQUIRES, SCMDP_CONFLICTS or SCMDP_ONE_OF */
+    int group; /* Number of AddConstraint() call the constraint is declared by */
+    char *key; /* Key of optional argument the constraint belongs to */
+    char *otherKey; /* Key of optional argument which is required, conflicting or grouped with it */
+} ScmdpConstraint;
+
+/* Compiled constraint, its bitmask over option ids lies in 'ruleMasks' of workspace */
+typedef struct
+{
+    int kind; /* SCMDP_REQUIRES, SCMDP_CONFLICTS or SCMDP_ONE_OF */
+    int optId; /* Id of optional argument the rule belongs to */
+} ScmdpRule;
+
+/**
+ * Limits of one parsing. The command line is rejected before the work on its arguments,
+ * so a huge or hostile command line costs no more than a correct one. 0 means no limit
+*/
+typedef struct
+{
+    int maxTokens; /* Maximal number of arguments (argv[0] is not counted) */
+    int maxTokenLength; /* Maximal length of one argument in bytes */
+    long long maxTotalBytes; /* Maximal length of all arguments in bytes */
+    int maxRepeats; /* Maximal number of entries of one optional argument, counts above 254 are not limited */
+} ScmdpBudget;
+
+/**
+ * Syntax of command line. It's compiled into the tables of workspace,
+ * so every character of argument is classified by one lookup whatever the profile is
+*/
+typedef struct
+{
+    char *prefixes; /* Characters beginning an optional argument (ex.: "-/") */
+    char *separators; /* Characters between key and value in one argument (ex.: "=" for --level=5), "" for none */
+    bool foldCase; /* If TRUE, keys are matched regardless of case of ASCII letters */
+    bool hasTerminator; /* If TRUE, '--' ends optional arguments */
+} ScmdpSyntax;
+
+/**
+ * Cache of the most used keys looked at before the hash table. Every slot keeps (hash << 32 | position + 1)
+ * of an entry of 'hotKeys' in one 64-bit word, so a slot is always read whole and checked against the key pool.
+ * Parsers never wait: the cache is rebuilt into the other buffer which is swapped in with one store
+*/
+typedef struct
+{
+    long long slots[2][SCMDP_HOT_CACHE_SIZE]; /* Two buffers of slots ordered by usage, 0 marks the end */
+    long long current; /* Buffer read by parsers, 0 or 1 */
+    long long isRebuilding; /* Nonzero while one of parsers rebuilds the cache */
+    long long *totals; /* Matches by option id reported by all parse contexts */
+    int interval; /* Number of parsings of context between its reports */
+} ScmdpHotCache;
+
+/**
+ * Receiver of paths matched by glob pattern of variadic argument. It's called by scanning threads
+ * one at a time, paths of one pattern come in no particular order
+ * 
+ * @returns FALSE to stop the scanning, otherwise TRUE
+*/
+typedef bool (*ScmdpGlobHandler)(char *path, void *userData);
+
+/* Expansion of glob patterns among the values of variadic argument (see EnableRestGlob()) */
+typedef struct
+{
+    int numOfThreads; /* Number of threads scanning the directories of one pattern */
+    ScmdpGlobHandler onMatch; /* Receives the values instead of context, NULL to keep them in context */
+    void *userData; /* Pointer passed to handler as it is */
+} ScmdpGlob;
+
+/**
+ * Provider of default value of optional argument. It's called only if the argument is absent
+ * 
+ * @returns Value of argument, it must live while the value is used, or NULL to leave it absent
+*/
+typedef char *(*ScmdpDefaultProvider)(int optId, void *userData);
+
+/**
+ * Action of optional argument. It's called for every entered argument after successful parsing
+ * 
+ * @returns FALSE to reject the value and fail the parsing, otherwise TRUE
+*/
+typedef bool (*ScmdpOptAction)(int optId, char *value, void *userData);
+
+/* Callbacks of optional argument, the table of them is indexed by option id */
+typedef struct
+{
+    ScmdpDefaultProvider provideDefault; /* Computes the value of absent argument, NULL for none */
+    void *defaultData; /* Pointer passed to provider as it is */
+    ScmdpOptAction action; /* Called for entered argument, NULL for none */
+    void *actionData; /* Pointer passed to action as it is */
+} ScmdpOptHooks;
+
+/* Output of non-valuable optional argument as a bit and a counter, the table of them is indexed by option id */
+typedef struct
+{
+    int bit; /* Position of bit in the bitset of flags, -1 if argument has no bit */
+    bool isCounter; /* If TRUE, repeated short key (ex.: -vvv) is matched and counted */
+    int *countPlace; /* Pointer of variable to write the number of entries, NULL for none */
+} ScmdpFlagOut;
+
+/* Type of value of optional argument, the table of them is indexed by option id */
+typedef struct
+{
+    int type; /* One of SCMDP_TYPE_... */
+    void *place; /* Pointer of variable to write the converted value (ex.: ScmdpNumbers *), NULL for none */
+} ScmdpOptType;
+
+/* Converted value of typed optional argument */
+typedef struct
+{
+    long long *values; /* Numbers or (start, end) pairs of ranges, they lie in the arena of parse context */
+    int count; /* Number of numbers or pairs, 0 if argument is absent */
+} ScmdpNumbers;
+
+/* Signature and format version of serialized workspace blob */
+#define SCMDP_BLOB_MAGIC 0x504D4353u
+#define SCMDP_BLOB_VERSION 16
+
+/* Entry of sorted key index used for prefix search (ex.: shell completion) */
+typedef struct
+{
+    char *key; /* Long or short key of argument, it points into 'keyPool' of workspace */
+    int id; /* Position of argument in 'optArgs' array or SCMDP_HELP_ID */
+} ScmdpKeyRef;
+
+/**
+ * Entry of hash table of keys. It keeps everything needed to match the key and to take its value,
+ * so matching touches only these 16 bytes and the key pool, not the arguments with their help strings
+*/
+typedef struct
+{
+    unsigned int hash; /* FNV-1a hash of key */
+    unsigned int offset; /* Position of key in 'keyPool' of workspace */
+    unsigned short length; /* Length of key, 0 marks an empty entry */
+    unsigned short isValuable; /* Nonzero if the argument takes a value */
+    int id; /* Position of argument in 'optArgs' array or SCMDP_HELP_ID */
+} ScmdpHotKey;
+
+/* Overlay of tenant over the shared workspace (see AddOverlay()) */
+typedef struct ScmdpOverlay ScmdpOverlay;
+
 /**
  * Structure of workspace. The main object of this library
  * Workspace is a structure contains all initialized arguments, full information
@@ -52,13 +259,318 @@ typedef struct
     ScmdpOptArg *optArgs; /* Dynamic array pointer for optional parameters */ 
     ScmdpNonOptArg *nonOptArgs; /* Dynamic array pointer for non-optional parameters */
     ScmdpHelpArg helpArg; /* Variable to write signature of argument calls help */
+    ScmdpRestArg restArg; /* Variadic non-optional argument, it's used if 'hasRestArg' is TRUE */
+    bool hasRestArg; /* If TRUE, the number of non-optional values may vary */
     int numOfOptArgs; /* Number of initialized optional parameters */
     int numOfValOptArgs; /* Number of valuable optional parameters */
     int numOfNonOptArgs; /* Number of initialized non-optional parameters */
     char *syntaxHelp; /* Syntax help string (ex.: USAGE app ARG1 ARG2 [-OPT]) */
     char *descriptHelp; /* Description of application purpose */
+    char *completeKey; /* Key switching the app to completion mode (ex.: --complete) */
+    ScmdpKeyRef *keyIndex; /* All keys sorted by their folded characters (see 'foldedChars'), built by workspace compilation */
+    int numOfKeys; /* Number of entries in key index */
+    ScmdpHotKey *hotKeys; /* Hash table of all keys, built by workspace compilation */
+    int hotKeysMask; /* Number of entries in hash table minus one (it's a power of two) */
+    char *keyPool; /* All keys one after another, every one is terminated by '\0' */
+    int keyPoolSize; /* Size of key pool in bytes */
+    bool isCompiled; /* If FALSE, the key index must be rebuilt before use */
+    int compileError; /* ERR_REPEATED_KEY, ERR_UNKNOWN_CONSTRAINT_KEY or ERR_TOO_LONG_KEY if the last compilation failed, otherwise ERR_NONE */
+    int repeatedOptIds[2]; /* Id of optional argument repeating the key and id of its first owner (SCMDP_HELP_ID for help), or id of failed option and -1 */
+    ScmdpOptHooks *optHooks; /* Callbacks of optional arguments by their id, NULL if none is set */
+    ScmdpFlagOut *flagOuts; /* Bits and counters of optional arguments by their id, NULL if none is set */
+    ScmdpOptType *optTypes; /* Types of values of optional arguments by their id, NULL if none is set */
+    int numOfFlagWords; /* Number of 64-bit words in the bitset of flags */
+    unsigned long long *flagsPlace; /* Pointer of bitset to write the flags, NULL for none */
+    ScmdpConstraint *constraints; /* Dynamic array of declared constraints */
+    int numOfConstraints; /* Number of declared constraints */
+    ScmdpRule *rules; /* Compiled constraints, one per AddConstraint() call */
+    int numOfRules; /* Number of compiled constraints */
+    unsigned long long *ruleMasks; /* Bitmasks of rules, 'numOfMaskWords' words per rule */
+    int numOfMaskWords; /* Number of 64-bit words in a bitmask over option ids */
+    ScmdpBudget budget; /* Limits of parsing, all zeros for none */
+    ScmdpHotCache *hotCache; /* Cache of the most used keys, NULL if usage isn't tracked */
+    ScmdpGlob *glob; /* Expansion of patterns of variadic argument, NULL if they are kept as they are */
+    unsigned char charClasses[256]; /* Classes of characters compiled from syntax profile (see SetSyntaxProfile()) */
+    unsigned char foldedChars[256]; /* Characters as keys are hashed and compared, letters are lowercase if case is folded */
+    char *jsonKeys; /* Escaped JSON names of arguments with comma and colon (ex.: ,"level":), built by the first FormatParseResult() */
+    unsigned int *jsonKeyOffsets; /* Positions of JSON names of optional, non-optional and variadic arguments, one more for the end */
+    ScmdpOverlay *overlay; /* Overlay whose keys are looked at first, NULL if workspace is not a view of overlay */
+    void *blob; /* Loaded blob which arrays of workspace point into, NULL if they are allocated */
+    size_t mappedSize; /* Size of file mapping owned by workspace, 0 if blob is not mapped */
 } ScmdpWorkspace;
 
+/* Default of optional argument set by overlay */
+typedef struct
+{
+    int optId; /* Id of optional argument of base or overlay */
+    ScmdpDefaultProvider provideDefault; /* Computes the value of absent argument */
+    void *defaultData; /* Pointer passed to provider as it is */
+} ScmdpOverlayDefault;
+
+/**
+ * Overlay of tenant over the shared base workspace. It keeps only its differences from base:
+ * added options with their own small hash table, ids of hidden options and changed defaults.
+ * Base is never changed, so any number of overlays share it and its memory
+*/
+struct ScmdpOverlay
+{
+    ScmdpWorkspace *base; /* Shared base workspace */
+    ScmdpWorkspace added; /* Options added by overlay, their ids follow the ids of base options */
+    int *hiddenIds; /* Sorted ids of hidden base options */
+    int numOfHidden; /* Number of hidden base options */
+    ScmdpOverlayDefault *defaults; /* Defaults replacing the defaults of base */
+    int numOfDefaults; /* Number of changed defaults */
+    ScmdpWorkspace view; /* Base as the parser sees it: arrays of base and pointer to this overlay, use it as workspace of contexts */
+    bool isCompiled; /* If FALSE, the view and the table of added keys must be rebuilt before use */
+};
+
+/* Structure of error occured during the parsing */
+typedef struct
+{
+    int code; /* Code of error (ex.: ERR_UNKNOWN_PARAMETER) or ERR_NONE */
+    int argIndex; /* Position of wrong argument in argv (number of arguments for ERR_WRONG_PARS_NUMBER) */
+    int optId; /* Id of optional argument violating the constraint, -1 if error is not about constraint */
+    int otherOptId; /* Id of required or conflicting optional argument, -1 if there's no one */
+    char *suggestions[SCMDP_MAX_SUGGESTIONS]; /* Keys nearest to unknown argument, nearest first, they point into the key pool */
+    int numOfSuggestions; /* Number of suggested keys */
+} ScmdpError;
+
+/**
+ * Structure of parse context. It keeps the results of one parsing and can be reused
+ * for the next parsing with the same workspace without any memory allocation
+*/
+typedef struct
+{
+    char **optVals; /* Values of optional arguments by their id, NULL if argument is absent */
+    char **nonOptVals; /* Values of non-optional arguments by their position */
+    char **restVals; /* Values of variadic argument, it points inside argv, to 'joinedVals' or to 'globVals' */
+    int numOfRestVals; /* Number of values of variadic argument */
+    int numOfOptArgs; /* Size of 'optVals' array */
+    int numOfNonOptArgs; /* Size of 'nonOptVals' array */
+    bool isHelpCalled; /* If TRUE, the help argument was entered */
+    ScmdpError error; /* Error of the last parsing */
+    unsigned long long *presentBits; /* Bitset of entered optional arguments by their id */
+    unsigned long long *flagBits; /* Bitset of entered flags by their bits (see SetOptFlag()) */
+    unsigned char *optCounts; /* Number of entries of every optional argument, 255 at most */
+    ScmdpNumbers *typedVals; /* Converted values of typed optional arguments by their id */
+    long long *arena; /* Numbers of all typed values, it's kept for the next parsing */
+    int arenaSize; /* Capacity of arena */
+    int arenaUsed; /* Number of numbers in arena */
+    unsigned long long *optionBits; /* Bitmap of arguments beginning with option prefix ('-' or '/') */
+    int optionBitsSize; /* Number of 64-bit words in 'optionBits' */
+    int helpIndex; /* Position of the first help key in argv, 0 if it's absent */
+    int terminatorIndex; /* Position of the first '--' in argv, 0 if it's absent */
+    int responseIndex; /* Position of the first response file marker ('@FILE') in argv, 0 if it's absent */
+    unsigned int *matchCounts; /* Matches by option id since the last report, NULL if usage isn't tracked */
+    int numOfTracked; /* Number of parsings since the last report */
+    char *pathPool; /* Values of variadic argument after glob expansion one after another, it's kept for the next parsing */
+    size_t pathPoolSize; /* Capacity of path pool in bytes */
+    size_t pathPoolUsed; /* Number of used bytes of path pool */
+    size_t *pathOffsets; /* Positions of values in path pool */
+    char **globVals; /* Values of variadic argument after glob expansion, they point into path pool */
+    int numOfPaths; /* Number of values in path pool */
+    int pathsSize; /* Capacity of 'pathOffsets' and 'globVals' */
+    char **joinedVals; /* Values of variadic argument from both sides of '--', they point inside argv */
+    int joinedValsSize; /* Capacity of 'joinedVals' */
+} ScmdpParseContext;
+
+/**
+ * Handler of console command. It's called after successful parsing of command arguments
+ * 
+ * @returns FALSE to stop the console, otherwise TRUE
+*/
+typedef bool (*ScmdpCommandHandler)(ScmdpWorkspace *workspace, ScmdpParseContext *context, void *userData);
+
+/**
+ * Reader of console lines, may be used for line editing and history
+ * 
+ * @returns Length of line written to buffer (without '\0') or -1 if there are no more lines
+*/
+typedef int (*ScmdpLineReader)(char *prompt, char *buffer, int bufferSize, void *userData);
+
+/* Structure of console command */
+typedef struct
+{
+    char *name; /* The first word of command line (ex.: connect) */
+    ScmdpWorkspace *workspace; /* Workspace describing arguments of command */
+    ScmdpParseContext context; /* Context reused for every call of command */
+    ScmdpCommandHandler handler; /* Function called with parsed arguments */
+    void *userData; /* Pointer passed to handler as it is */
+} ScmdpCommand;
+
+/**
+ * Structure of console. It reads lines from file descriptor, splits them into words in place
+ * and dispatches them to the command handlers. All buffers are allocated once
+*/
+typedef struct
+{
+    ScmdpCommand *commands; /* Dynamic array of commands */
+    int numOfCommands; /* Number of added commands */
+    int fd; /* File descriptor to read lines */
+    char *prompt; /* String printed before every line, NULL for none */
+    char *line; /* Buffer of SCMDP_LINE_SIZE bytes for read lines */
+    int lineStart; /* Beginning of unprocessed data in line buffer */
+    int lineEnd; /* End of read data in line buffer */
+    bool isSkipping; /* If TRUE, the rest of too long line is skipped */
+    long long numOfLongLines; /* Number of skipped too long lines, the reader of console reports them */
+    char **tokens; /* Words of current line, SCMDP_MAX_TOKENS at most */
+    ScmdpLineReader readLine; /* Custom reader of lines or NULL to read from fd */
+    void *readLineData; /* Pointer passed to reader as it is */
+} ScmdpConsole;
+
+/* Slot of server queue. The line is copied once and split into words in place by the worker */
+typedef struct
+{
+    long long sequence; /* Turn of the slot: free for writing or ready for reading */
+    char line[SCMDP_LINE_SIZE]; /* Command line read by server */
+} ScmdpServerSlot;
+
+/* Snapshot of server counters (see GetServerMetrics()) */
+typedef struct
+{
+    long long numOfLines; /* Lines put into queue */
+    long long numOfHandled; /* Commands whose handler returned TRUE */
+    long long numOfFailed; /* Too long lines, lines with unknown command or wrong arguments, or handler returned FALSE */
+    long long queueDepth; /* Lines waiting in queue or being handled now */
+    long long maxQueueDepth; /* The largest depth of queue */
+    double seconds; /* Time of serving */
+    double linesPerSecond; /* Throughput of serving */
+} ScmdpServerMetrics;
+
+/**
+ * Structure of server. It reads lines of console and dispatches them to a fixed pool of workers
+ * through the bounded lock-free queue. Every worker has its own parse contexts and words buffer,
+ * so the compiled workspaces of commands are shared without locks
+*/
+typedef struct
+{
+    ScmdpConsole *console; /* Console reading lines and keeping commands */
+    int numOfWorkers; /* Number of worker threads */
+    ScmdpParseContext *contexts; /* Context of every command for every worker */
+    char **tokens; /* Words of current line for every worker, SCMDP_MAX_TOKENS+1 each */
+    ScmdpServerSlot *slots; /* Ring of queued lines */
+    long long numOfSlots; /* Size of ring, a power of two */
+    long long head; /* Position of the next line to handle, moved by workers */
+    long long tail; /* Position of the next line to read, moved by server */
+    long long isClosed; /* Nonzero when there are no more lines */
+    long long isStopping; /* Nonzero when a handler asked to stop */
+    long long numOfLines; /* Counters of metrics */
+    long long numOfHandled;
+    long long numOfFailed;
+    long long maxQueueDepth;
+    long long startTime; /* Time of serving in nanoseconds */
+    long long stopTime;
+    void *workers; /* Threads of workers, platform specific */
+} ScmdpServer;
+
+/**
+ * Values of optional arguments taken from config files. The snapshot is never changed after it's published,
+ * values lie in the same memory block with it
+*/
+typedef struct
+{
+    char **optVals; /* Values of optional arguments by their id, NULL if argument is absent in all files */
+    int numOfOptArgs; /* Size of 'optVals' array */
+} ScmdpConfigValues;
+
+/**
+ * Handler of changed config. It's called after the new values are published
+ * 
+ * @param values New values of config
+ * @param changedIds Ids of optional arguments whose values are changed, in order of ids
+ * @param numOfChanged Number of changed arguments
+ * @param userData Pointer passed to AddConfigWatch()
+ */
+typedef void (*ScmdpConfigHandler)(ScmdpConfigValues *values, int *changedIds, int numOfChanged, void *userData);
+
+/* Config file of watch with its own values */
+typedef struct
+{
+    char *path; /* Path of file */
+    char *name; /* Name of file in its folder, it points into 'path' */
+    char *text; /* Text of file split into words, values point into it */
+    char **optVals; /* Values of optional arguments of this file by their id */
+    int folderWatch; /* Watch descriptor of folder of file, -1 if it's not watched */
+    long long modifyTime; /* Time of the last change of file, it's compared if folder is not watched */
+    long long size; /* Size of file at the last reading */
+    bool isChanged; /* File is changed since the last reading */
+} ScmdpConfigFile;
+
+/**
+ * Structure of config watch. Files hold options as they are written in command line, the later files override
+ * the earlier ones. Only the changed file is parsed again; the new values are published by swap of pointer,
+ * so readers never wait, and the old values are freed when all their readers leave them (RCU)
+*/
+typedef struct
+{
+    ScmdpWorkspace *workspace; /* Compiled workspace describing options */
+    ScmdpParseContext context; /* Context for parsing of files */
+    ScmdpConfigFile *files; /* Watched files */
+    int numOfFiles; /* Number of watched files */
+    ScmdpConfigValues *current; /* Published values, read with EnterConfig() */
+    long long epoch; /* Number of publications, its lowest bit chooses the readers counter */
+    long long readers[2]; /* Numbers of readers entered in even and odd epochs */
+    char **mergedVals; /* Values of all files by option id before publishing */
+    int *changedIds; /* Ids of changed options for handler */
+    ScmdpConfigHandler onChange; /* Handler of changes, NULL for none */
+    void *userData; /* Pointer passed to handler */
+    ScmdpError error; /* Error of the last reading of file, argIndex is the number of wrong word in file */
+    int notifier; /* Descriptor of inotify on Linux, -1 if files are compared by time */
+} ScmdpConfigWatch;
+
+/**
+ * Header of serialized workspace blob
+ * The header is followed by the workspace structure, arrays of optional arguments,
+ * non-optional arguments, key index and the pool of keys. Help strings and value names
+ * lie in the help pool after them at a page boundary.
+ * Every pointer inside the blob keeps an offset from the blob beginning (0 means NULL)
+ * and is fixed up in place when the blob is loaded; pointers into the help pool are fixed up
+ * when the help is shown first, so the pages of help text are never read by normal startups
+*/
+typedef struct
+{
+    unsigned int magic; /* SCMDP_BLOB_MAGIC, also detects the byte order */
+    unsigned int version; /* SCMDP_BLOB_VERSION */
+    unsigned int pointerSize; /* sizeof(void *) of the platform blob was made on */
+    unsigned int checksum; /* FNV-1a hash of everything after the header up to the help pool */
+    unsigned long long size; /* Size of the whole blob in bytes */
+    unsigned long long relocatedBase; /* Address the blob was fixed up at, 0 if it's not fixed up yet */
+    unsigned long long helpOffset; /* Position of help pool, a multiple of 4096 */
+    long long helpState; /* 0 while pointers into help pool keep offsets, 1 while they are fixed up, 2 after */
+    unsigned int helpChecksum; /* FNV-1a hash of help pool */
+} ScmdpBlobHeader;
+
+/* Signature and format version of columnar file of parsed command log */
+#define SCMDP_COLUMNS_MAGIC 0x4C434353u
+#define SCMDP_COLUMNS_VERSION 1
+
+/* Statuses of lines of command log besides ERR_NONE and codes of errors */
+#define SCMDP_STATUS_HELP -2 /* The help argument was entered */
+#define SCMDP_STATUS_EMPTY -3 /* The line has no words */
+
+/**
+ * Header of columnar file made by ParseLogFile(). It's followed by the status column and one column
+ * per option id. Every column keeps one byte per line of log and takes 'columnSize' bytes,
+ * so the column of one option is read sequentially without touching the others
+*/
+typedef struct
+{
+    unsigned int magic; /* SCMDP_COLUMNS_MAGIC */
+    unsigned int version; /* SCMDP_COLUMNS_VERSION */
+    unsigned long long numOfRows; /* Number of lines of log */
+    unsigned long long columnSize; /* Distance between columns in bytes, a multiple of 64 */
+    unsigned int numOfOptArgs; /* Number of option columns */
+    unsigned int headerSize; /* Position of the status column in file */
+} ScmdpColumnsHeader;
+
+/* Columnar file mapped back into memory (see LoadColumnsFile()) */
+typedef struct
+{
+    ScmdpColumnsHeader *header; /* Beginning of mapped file */
+    signed char *status; /* Status of every line: ERR_NONE, SCMDP_STATUS_... or code of error */
+    size_t mappedSize; /* Size of file mapping */
+} ScmdpColumns;
+
 /**
  * @brief Initialize a new workspace object
  * 
@@ -81,6 +593,41 @@ ScmdpWorkspace AddWorkspace(char *syntaxHelp, char *description);
  */
 void AddHelpArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey);
 
+/**
+ * @brief Initializes a variadic non-optional argument. It takes all non-optional values after
+ * the ones of AddNonOptArg(), so the command line looks like 'app [-OPT] ARG1 FILE...'.
+ * Everything after '--' is taken as non-optional values even if it begins with '-' or '/'.
+ * The values are not copied: the variable gets a pointer inside argv and their number
+ * 
+ * @warning The new variadic argument initialization will overwrite the previous one.
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param key String contains the name of argument (ex.: FILE)
+ * @param help String contains description of argument
+ * @param minCount Minimal number of values
+ * @param maxCount Maximal number of values, -1 if it's unlimited
+ * @param valPlace The pointer to drop the pointer to the first value inside argv
+ * @param countPlace The pointer to drop the number of values
+ * 
+ * @returns Nothing
+ */
+void AddRestArg(ScmdpWorkspace *workspace, char *key, char *help, int minCount, int maxCount, char ***valPlace, int *countPlace);
+
+/**
+ * @brief Initializes an argument that switches the app into shell completion mode.
+ * Completion is requested as 'app KEY CWORD WORD0 WORD1 ...', where WORDs are the words
+ * of edited command line (WORD0 is the app name) and CWORD is the index of word under cursor.
+ * All keys beginning with the word under cursor are printed one per line with a single write.
+ * 
+ * @warning The new completion argument initialization will overwrite the previous one.
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param key String contains the completion key (ex.: --complete)
+ * 
+ * @returns Nothing
+ */
+void AddCompleteArg(ScmdpWorkspace *workspace, char *key);
+
 /**
  * @brief Initializes a new optional argument
  * It is added to the end of the 'workspace->optional' array with memory reallocation
@@ -94,9 +641,9 @@ void AddHelpArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey);
  * @param valName The name of value (ex. -option OPTION), use "" or NULL to make an argument non-valuable
  * @param valPlace The pointer to drop value. If it's non-valuable it drops a "true" string.
  * 
- * @returns Nothing
+ * @returns Id of argument (its position in 'workspace->optArgs')
 */
-void AddOptArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey, char *help, char *valName, char **valPlace);
+int AddOptArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey, char *help, char *valName, char **valPlace);
 
 /**
  * @brief Initializes a new non-optional argument
@@ -109,9 +656,156 @@ void AddOptArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey, char *h
  * @param help String contains description of parameter
  * @param valPlace The string's pointer to drop value. The value of non-optional argument is neccessary!
  * 
- * @returns Nothing
+ * @returns Position of argument in 'workspace->nonOptArgs'
 */
-void AddNonOptArg(ScmdpWorkspace *workspace, char *key, char *help, char **valPlace);
+int AddNonOptArg(ScmdpWorkspace *workspace, char *key, char *help, char **valPlace);
+
+/**
+ * @brief Declares a constraint between optional arguments. Constraints are compiled into bitmasks
+ * over option ids and checked after successful parsing
+ * SCMDP_REQUIRES - if 'key' is entered, all 'otherKeys' must be entered too
+ * SCMDP_CONFLICTS - if 'key' is entered, none of 'otherKeys' may be entered
+ * SCMDP_ONE_OF - at least one of 'key' and 'otherKeys' must be entered
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param kind Kind of constraint
+ * @param key Long or short key of optional argument
+ * @param otherKeys Array of long or short keys of other optional arguments
+ * @param numOfOtherKeys Number of keys in array
+ * 
+ * @returns Nothing
+ */
+void AddConstraint(ScmdpWorkspace *workspace, int kind, char *key, char *otherKeys[], int numOfOtherKeys);
+
+/**
+ * @brief Sets the provider of default value of optional argument. It's called after successful parsing
+ * only if the argument is absent, so expensive defaults (ex.: probing the CPU count) cost nothing otherwise
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of optional argument returned by AddOptArg()
+ * @param provideDefault Provider of value, NULL to remove it
+ * @param userData Pointer passed to provider as it is
+ * 
+ * @returns TRUE, if the argument exists. Otherwise, FALSE.
+ */
+bool SetOptDefault(ScmdpWorkspace *workspace, int optId, ScmdpDefaultProvider provideDefault, void *userData);
+
+/**
+ * @brief Sets the action of optional argument. Actions of all entered arguments are called
+ * in order of their ids after successful parsing, before the values are scattered
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of optional argument returned by AddOptArg()
+ * @param action Function called with the value of argument ("true" for non-valuable one), NULL to remove it
+ * @param userData Pointer passed to action as it is
+ * 
+ * @returns TRUE, if the argument exists. Otherwise, FALSE.
+ */
+bool SetOptAction(ScmdpWorkspace *workspace, int optId, ScmdpOptAction action, void *userData);
+
+/**
+ * @brief Maps the non-valuable optional argument to the bit of flags bitset. Testing a flag costs one AND
+ * and the whole set of flags may be compared or hashed at once
+ * 
+ * @warning Set bits before parse contexts are made, the bitset of context is sized by the largest bit
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of non-valuable optional argument returned by AddOptArg()
+ * @param bit Position of bit, -1 to remove it
+ * 
+ * @returns TRUE, if the argument exists and it's non-valuable. Otherwise, FALSE.
+ */
+bool SetOptFlag(ScmdpWorkspace *workspace, int optId, int bit);
+
+/**
+ * @brief Makes the non-valuable optional argument a counter. It may be repeated, and its short key
+ * with repeated last character (ex.: -vvv for -v) counts as many entries
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of non-valuable optional argument returned by AddOptArg()
+ * @param countPlace The pointer to drop the number of entries, NULL for none
+ * 
+ * @returns TRUE, if the argument exists and it's non-valuable. Otherwise, FALSE.
+ */
+bool SetOptCounter(ScmdpWorkspace *workspace, int optId, int *countPlace);
+
+/**
+ * @brief Binds the bitset to drop flags after successful parsing (see SetOptFlag())
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param flagsPlace Array of (largest bit / 64 + 1) words, NULL for none
+ * 
+ * @returns Nothing
+ */
+void BindFlagsPlace(ScmdpWorkspace *workspace, unsigned long long *flagsPlace);
+
+/**
+ * @brief Sets the limits of parsing (see ScmdpBudget). A command line over them fails with ERR_OVER_BUDGET
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param budget Limits of parsing, zero fields are not limited
+ * 
+ * @returns Nothing
+ */
+void SetParseBudget(ScmdpWorkspace *workspace, ScmdpBudget budget);
+
+/**
+ * @brief Turns on tracking of matched options. Every parse context counts matches by itself and
+ * reports them after 'interval' parsings, then the cache of the most used keys is rebuilt.
+ * Contexts made before this call are not tracked
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param interval Number of parsings of context between its reports
+ * 
+ * @returns Nothing
+ */
+void EnableHotKeyCache(ScmdpWorkspace *workspace, int interval);
+
+/**
+ * @brief Sets the syntax of command line: prefixes of optional arguments, value separators,
+ * case folding of keys and '--' terminator. Workspace uses SCMDP_SYNTAX_DEFAULT until it's called
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param syntax Syntax profile (ex.: SCMDP_SYNTAX_POSIX)
+ * 
+ * @returns Nothing
+ */
+void SetSyntaxProfile(ScmdpWorkspace *workspace, ScmdpSyntax syntax);
+
+/**
+ * @brief Turns on expansion of glob patterns among the values of variadic argument, for shells and
+ * server commands passing them as they are (ex.: *.gz). Patterns support '*', '?', '[a-z]', '[!a-z]'
+ * and '**' for any number of directories; wildcards don't match names beginning with '.'.
+ * Directories are scanned in parallel after successful parsing, the matches of every pattern are sorted
+ * and kept in the path pool of context. A pattern matching nothing is kept as it is
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param numOfThreads Number of threads scanning the directories of one pattern, the calling one included
+ * @param onMatch Handler receiving all values of variadic argument as they are found, so they are not kept;
+ * 'restVals' of context is empty then. NULL to keep the values in context
+ * @param userData Pointer passed to handler as it is
+ * 
+ * @returns Nothing
+ */
+void EnableRestGlob(ScmdpWorkspace *workspace, int numOfThreads, ScmdpGlobHandler onMatch, void *userData);
+
+/**
+ * @brief Sets the type of value of optional argument. The value is converted after successful parsing
+ * into the arena of parse context, the string value is still dropped to valPlace
+ * SCMDP_TYPE_INT_LIST - comma-separated integers and ranges (ex.: 0-15,32,40-47) expanded to integers
+ * SCMDP_TYPE_RANGE_LIST - the same kept as (start, end) pairs, a single integer N gives (N, N)
+ * SCMDP_TYPE_SIZE - size in bytes with optional fraction and suffix (ex.: 64MiB, 1.5G, 100KB)
+ * SCMDP_TYPE_DURATION - duration in nanoseconds as a sequence of numbers with units (ex.: 250ms, 2h30m)
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of valuable optional argument returned by AddOptArg()
+ * @param type Type of value
+ * @param place The pointer to drop converted value (ScmdpNumbers * for lists, long long * for others), NULL for none.
+ * Values live in the arena of context until its next parsing; after ParseArgs() they live until the program ends
+ * 
+ * @returns TRUE, if the argument exists and it's valuable. Otherwise, FALSE.
+ */
+bool SetOptType(ScmdpWorkspace *workspace, int optId, int type, void *place);
 
 /**
  * @brief Parses the entered arguments and scatters them at the addresses (**place) for the given arguments
@@ -125,5 +819,426 @@ void AddNonOptArg(ScmdpWorkspace *workspace, char *key, char *help, char **valPl
 */
 bool ParseArgs(ScmdpWorkspace *workspace, int argc, char *argv[]);
 
+/**
+ * @brief Initializes a new parse context for the workspace
+ * 
+ * @param workspace Initialized workspace pointer. It's compiled if it's not yet
+ * 
+ * @returns New parse context. If a key of workspace is repeated, its 'error' is ERR_REPEATED_KEY
+ * with both options, if a constraint has a key of no option, it's ERR_UNKNOWN_CONSTRAINT_KEY,
+ * if a key is longer than 65535 characters, it's ERR_TOO_LONG_KEY.
+ * Every parsing in such context fails with the same error
+ */
+ScmdpParseContext AddParseContext(ScmdpWorkspace *workspace);
+
+/**
+ * @brief Parses the entered arguments into the context, the workspace is kept for the next parsing.
+ * Nothing is printed. Memory is allocated only if the context never had so many arguments. If the parsing is successful, the values
+ * are also scattered at the addresses (**place) which are not NULL
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param context Parse context made for this workspace
+ * @param argc Number of arguments, argv[0] is skipped as in int main(...)
+ * @param argv Arguments
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE and 'context->error' is set.
+*/
+bool ParseArgsInContext(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Writes the result of parsing as JSON object into the buffer.
+ * Names are escaped once by the first call for the workspace, later calls don't allocate anything.
+ * Names are the keys without prefixes (ex.: "level" for --level), flags are true, counters are numbers.
+ * Failed parsing gives {"error":code,"argIndex":index} and called help gives {"help":true}
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Context of the parsing
+ * @param buffer Buffer for JSON, it's terminated by '\0' if there's room for it
+ * @param bufferSize Size of buffer
+ * @param format SCMDP_FORMAT_JSON or SCMDP_FORMAT_NDJSON, which ends the object with '\n' to append the lines one after another
+ * 
+ * @returns Length of JSON. If it's more than bufferSize, the buffer is not enough and its content is incomplete
+ */
+size_t FormatParseResult(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *buffer, size_t bufferSize, int format);
+
+/**
+ * @brief Releases the memory of parse context
+ * 
+ * @param context Parse context pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteParseContext(ScmdpParseContext *context);
+
+/**
+ * @brief Removes the workspace which is not passed to ParseArgs() from memory
+ * 
+ * @param workspace Initialized workspace pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteWorkspace(ScmdpWorkspace *workspace);
+
+/**
+ * @brief Initializes a new overlay over the base workspace. Base must not be changed after overlays are made
+ * 
+ * @param base Initialized workspace pointer shared by overlays
+ * 
+ * @returns New overlay
+ */
+ScmdpOverlay AddOverlay(ScmdpWorkspace *base);
+
+/**
+ * @brief Adds the optional argument to overlay. Its keys are looked at before the keys of base, so they may replace them
+ * 
+ * @param overlay Initialized overlay pointer
+ * @param longKey, shortKey, help, valName, valPlace The same as in AddOptArg()
+ * 
+ * @returns Id of optional argument, it follows the ids of base options
+ */
+int AddOverlayOptArg(ScmdpOverlay *overlay, char *longKey, char *shortKey, char *help, char *valName, char **valPlace);
+
+/**
+ * @brief Hides the optional argument of base, its keys become unknown in overlay
+ * 
+ * @param overlay Initialized overlay pointer
+ * @param optId Id of optional argument of base
+ * 
+ * @returns TRUE, if the argument is hidden. FALSE, if there's no such argument
+ */
+bool HideOverlayOptArg(ScmdpOverlay *overlay, int optId);
+
+/**
+ * @brief Sets the default of valuable optional argument in overlay, it replaces the default of base
+ * 
+ * @param overlay Initialized overlay pointer
+ * @param optId Id of optional argument of base or overlay
+ * @param provideDefault Function giving the value of absent argument
+ * @param userData Pointer passed to provider as it is
+ * 
+ * @returns TRUE, if the default is set. FALSE, if there's no such valuable argument
+ */
+bool SetOverlayDefault(ScmdpOverlay *overlay, int optId, ScmdpDefaultProvider provideDefault, void *userData);
+
+/**
+ * @brief Initializes a new parse context for the overlay. Overlay is compiled if it's not yet
+ * 
+ * @param overlay Initialized overlay pointer
+ * 
+ * @returns New parse context with room for options of base and overlay
+ */
+ScmdpParseContext AddOverlayContext(ScmdpOverlay *overlay);
+
+/**
+ * @brief Parses the arguments with the options of base changed by overlay. It's ParseArgsInContext() with 'overlay->view'
+ * 
+ * @param overlay Compiled overlay pointer
+ * @param context Parse context made by AddOverlayContext()
+ * @param argc Number of arguments, argv[0] is skipped as in int main(...)
+ * @param argv Arguments
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE and 'context->error' is set.
+ */
+bool ParseArgsInOverlay(ScmdpOverlay *overlay, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Releases the memory of overlay, base is not touched
+ * 
+ * @param overlay Initialized overlay pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteOverlay(ScmdpOverlay *overlay);
+
+/**
+ * @brief Initializes a new console reading command lines from file descriptor
+ * 
+ * @param fd File descriptor to read (ex.: 0 for stdin)
+ * @param prompt String printed before every line, NULL for none
+ * 
+ * @returns New console object
+ */
+ScmdpConsole AddConsole(int fd, char *prompt);
+
+/**
+ * @brief Adds a new command to the console. Its workspace is compiled and parse context is made once
+ * 
+ * @warning Values of the command point into the line buffer and live until the next line is read
+ * 
+ * @param console Initialized console pointer
+ * @param name The first word of command line
+ * @param workspace Workspace describing arguments of command, it must outlive the console
+ * @param handler Function called with parsed arguments
+ * @param userData Pointer passed to handler as it is
+ * 
+ * @returns Nothing
+ */
+void AddConsoleCommand(ScmdpConsole *console, char *name, ScmdpWorkspace *workspace, ScmdpCommandHandler handler, void *userData);
+
+/**
+ * @brief Replaces reading of file descriptor with the custom reader (ex.: with line editing and history)
+ * 
+ * @param console Initialized console pointer
+ * @param readLine Reader of lines, NULL to read file descriptor again
+ * @param userData Pointer passed to reader as it is
+ * 
+ * @returns Nothing
+ */
+void SetConsoleReader(ScmdpConsole *console, ScmdpLineReader readLine, void *userData);
+
+/**
+ * @brief Splits the line into words in place and executes the command
+ * Words are separated by spaces, quotes ("" or '') and backslash keep spaces inside the word
+ * 
+ * @param console Initialized console pointer
+ * @param line Writable command line
+ * 
+ * @returns FALSE if the command handler asks to stop the console, otherwise TRUE
+ */
+bool ExecuteConsoleLine(ScmdpConsole *console, char *line);
+
+/**
+ * @brief Reads and executes the command lines until the end of input or until a handler stops it
+ * 
+ * @param console Initialized console pointer
+ * 
+ * @returns Nothing
+ */
+void RunConsole(ScmdpConsole *console);
+
+/**
+ * @brief Releases the memory of console and all parse contexts of commands. Workspaces are not removed
+ * 
+ * @param console Initialized console pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteConsole(ScmdpConsole *console);
+
+/**
+ * @brief Initializes a new server for commands of console. Parse contexts are made for every worker,
+ * so all commands should be added to the console before
+ * 
+ * @warning Handlers are called from worker threads at the same time, they must be thread-safe.
+ * Values of arguments point into the queue slot and live until the handler returns
+ * 
+ * @param console Initialized console pointer, it gives lines and commands
+ * @param numOfWorkers Number of worker threads
+ * @param queueSize Number of lines the queue keeps, it's rounded up to a power of two
+ * 
+ * @returns New server object
+ */
+ScmdpServer AddServer(ScmdpConsole *console, int numOfWorkers, int queueSize);
+
+/**
+ * @brief Starts workers, reads lines of console until the end of input or until a handler stops it.
+ * Returns when all queued lines are handled
+ * 
+ * @param server Initialized server pointer
+ * 
+ * @returns FALSE if worker threads can't be started, otherwise TRUE
+ */
+bool RunServer(ScmdpServer *server);
+
+/**
+ * @brief Takes a snapshot of server counters. It may be called from any thread (ex.: from handler)
+ * 
+ * @param server Initialized server pointer
+ * 
+ * @returns Metrics of server
+ */
+ScmdpServerMetrics GetServerMetrics(ScmdpServer *server);
+
+/**
+ * @brief Releases the memory of server and parse contexts of workers. Console is not removed
+ * 
+ * @param server Initialized server pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteServer(ScmdpServer *server);
+
+/**
+ * @brief Initializes a new config watch. Files are added by AddConfigFile(), changes are taken by PollConfigWatch()
+ * 
+ * @param workspace Workspace describing options of config. It's compiled if it's not yet
+ * @param onChange Handler of changed values, NULL for none
+ * @param userData Pointer passed to handler
+ * 
+ * @returns New config watch
+ */
+ScmdpConfigWatch AddConfigWatch(ScmdpWorkspace *workspace, ScmdpConfigHandler onChange, void *userData);
+
+/**
+ * @brief Reads and parses the config file, publishes its values and starts to watch it.
+ * Every line holds options as they are written in command line (ex.: --level 5), lines beginning with '#' are comments
+ * 
+ * @param watch Initialized config watch pointer
+ * @param path Path of file
+ * 
+ * @returns TRUE, if the file is read and parsed. Otherwise, FALSE (see watch->error)
+ */
+bool AddConfigFile(ScmdpConfigWatch *watch, char *path);
+
+/**
+ * @brief Waits for changes of config files, parses only the changed ones again and publishes the new values.
+ * The handler gets only the options whose values are changed. A file with errors keeps its previous values
+ * 
+ * @param watch Initialized config watch pointer
+ * @param timeout Time to wait for changes in milliseconds
+ * 
+ * @returns Number of changed options or -1 if the watch is broken
+ */
+int PollConfigWatch(ScmdpConfigWatch *watch, int timeout);
+
+/**
+ * @brief Begins reading of published config values. It never waits and it may be called from any thread
+ * 
+ * @param watch Initialized config watch pointer
+ * @param values Pointer to drop the values, they are valid until LeaveConfig()
+ * 
+ * @returns Ticket for LeaveConfig()
+ */
+int EnterConfig(ScmdpConfigWatch *watch, ScmdpConfigValues **values);
+
+/**
+ * @brief Ends reading of config values got by EnterConfig()
+ * 
+ * @param watch Initialized config watch pointer
+ * @param ticket Ticket returned by EnterConfig()
+ * 
+ * @returns Nothing
+ */
+void LeaveConfig(ScmdpConfigWatch *watch, int ticket);
+
+/**
+ * @brief Stops watching and releases the memory of config watch. There must be no readers
+ * 
+ * @param watch Initialized config watch pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteConfigWatch(ScmdpConfigWatch *watch);
+
+/**
+ * @brief Serializes the workspace with key index, all strings and help text into a relocatable blob.
+ * Pointers to variables (valPlace) are not saved, bind them after loading with BindValPlace()
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param buffer Memory to write the blob, aligned as a pointer. Use NULL to get the size only
+ * @param bufferSize Size of buffer in bytes
+ * 
+ * @returns Size of the blob, 0 if a key of workspace is repeated. Nothing is written if it's larger than bufferSize
+ */
+size_t SaveWorkspace(ScmdpWorkspace *workspace, void *buffer, size_t bufferSize);
+
+/**
+ * @brief Serializes the workspace to the file (see SaveWorkspace())
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param path Path of the file to write
+ * 
+ * @returns TRUE, if the file was written. Otherwise, FALSE.
+ */
+bool SaveWorkspaceFile(ScmdpWorkspace *workspace, char *path);
+
+/**
+ * @brief Loads the workspace from the blob without any parsing or memory allocation.
+ * The blob is validated by checksum and its offsets are fixed up to pointers in place.
+ * Help text is not read until the help is shown (see LoadHelpText())
+ * 
+ * @warning The blob must be writable, aligned as a pointer and stay alive while the workspace is used
+ * (ex.: static _Alignas(8) unsigned char spec[] = {...};). Don't add new arguments to the loaded workspace
+ * 
+ * @param workspace Pointer to the workspace to initialize
+ * @param blob Memory with the blob made by SaveWorkspace()
+ * @param size Size of memory in bytes
+ * 
+ * @returns TRUE, if the blob is valid. Otherwise, FALSE.
+ */
+bool LoadWorkspace(ScmdpWorkspace *workspace, void *blob, size_t size);
+
+/**
+ * @brief Loads the workspace from the file by memory-mapping (see LoadWorkspace())
+ * The file is mapped copy-on-write, so only pages touched by pointer fix-ups are copied.
+ * The mapping is released together with the workspace
+ * 
+ * @param workspace Pointer to the workspace to initialize
+ * @param path Path of the file made by SaveWorkspaceFile()
+ * 
+ * @returns TRUE, if the file is a valid blob. Otherwise, FALSE.
+ */
+bool LoadWorkspaceFile(ScmdpWorkspace *workspace, char *path);
+
+/**
+ * @brief Fixes up help strings and value names of the loaded workspace. The help calls it by itself,
+ * it's needed only to read them directly (ex.: workspace.optArgs[id].help)
+ * 
+ * @param workspace Initialized workspace pointer, nothing is done if it's not loaded from a blob
+ * 
+ * @returns Nothing
+ */
+void LoadHelpText(ScmdpWorkspace *workspace);
+
+/**
+ * @brief Binds the variable to drop value of argument of the loaded workspace
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param key Long or short key of optional argument or name of non-optional argument
+ * @param valPlace The pointer to drop value
+ * 
+ * @returns TRUE, if the argument was found. Otherwise, FALSE.
+ */
+bool BindValPlace(ScmdpWorkspace *workspace, char *key, char **valPlace);
+
+/**
+ * @brief Parses the log of command lines, one per line, and writes which options every line used
+ * into the columnar file (see ScmdpColumnsHeader). The log is memory-mapped and split into shards
+ * at line ends; every shard is split into words and parsed by its own thread with its own context.
+ * The first word of line is the command name like argv[0]. Option columns keep the number of entries,
+ * 255 at most, for successfully parsed lines and 0 for the others. Actions and glob expansion are not run
+ * 
+ * @param workspace Initialized workspace pointer, it's shared by all threads
+ * @param logPath Path of log file
+ * @param columnsPath Path of columnar file to make, it's overwritten
+ * @param numOfThreads Number of shards and threads, the calling one included
+ * 
+ * @returns Number of lines of log or -1, if files can't be mapped
+ */
+long long ParseLogFile(ScmdpWorkspace *workspace, char *logPath, char *columnsPath, int numOfThreads);
+
+/**
+ * @brief Maps the columnar file made by ParseLogFile() for reading
+ * 
+ * @param columns Pointer to the columns to initialize
+ * @param path Path of columnar file
+ * 
+ * @returns TRUE, if the file is a valid columnar file. Otherwise, FALSE.
+ */
+bool LoadColumnsFile(ScmdpColumns *columns, char *path);
+
+/**
+ * @brief Finds the column of optional argument
+ * 
+ * @param columns Loaded columns pointer
+ * @param optId Id of optional argument returned by AddOptArg()
+ * 
+ * @returns Numbers of entries of argument in every line, NULL if there's no such column
+ */
+unsigned char *GetOptColumn(ScmdpColumns *columns, int optId);
+
+/**
+ * @brief Releases the mapping of columnar file
+ * 
+ * @param columns Loaded columns pointer
+ * 
+ * @returns Nothing
+ */
+void DeleteColumns(ScmdpColumns *columns);
+
+#ifdef __cplusplus
+}
+#endif
+
 /* If scmdp is not yet connected it will be compiled */
 #endif
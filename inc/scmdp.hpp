@@ -0,0 +1,465 @@
+/* At first check if SCMDP C++ wrapper is connected yet */
+#ifndef HPP_SCMDP
+#define HPP_SCMDP
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "scmdp.h"
+
+/**
+ * Header-only C++17 front of scmdp. The spec of arguments is constexpr data: the perfect hash of keys
+ * is built by the compiler, so parsing only hashes the argument once and compares it with one key.
+ * The parser behaves as the one generated by scmdpgen and never allocates memory
+*/
+namespace scmdp
+{
+
+/* Optional argument of spec, strings are expected to be literals */
+struct Option
+{
+    std::string_view longKey; /* Long parameter (ex.: --help) */
+    std::string_view shortKey; /* Short parameter (ex.: -h), may be empty */
+    std::string_view help; /* Help string of argument */
+    std::string_view valName; /* Name of value (ex.: FILE), empty for non-valuable argument */
+};
+
+/* Non-optional argument of spec */
+struct Positional
+{
+    std::string_view key; /* Name of argument in help */
+    std::string_view help; /* Help string of argument */
+};
+
+/* Identifier of the help argument and of the unknown key */
+constexpr int helpId = SCMDP_HELP_ID;
+constexpr int unknownId = -2;
+
+/**
+ * @brief Calculates FNV-1a hash of key, the same for compile time and parsing
+ */
+constexpr std::uint64_t HashKey(std::string_view key)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char symbol : key)
+    {
+        hash ^= static_cast<unsigned char>(symbol);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief These functions are never defined as constexpr, so calling them while the spec is compiled stops
+ * the compilation with their names in the message
+ */
+inline void KeyIsUsedTwice() {}
+inline void PerfectHashIsNotFound() {}
+inline void KeyIsUnknown() {}
+
+/**
+ * Values of arguments after parsing. Values point into argv, so the result is moved but never copied
+*/
+template <std::size_t NumOfOptions, std::size_t NumOfPositionals>
+class Result
+{
+public:
+    Result() = default;
+    Result(Result &&) = default;
+    Result &operator=(Result &&) = default;
+    Result(const Result &) = delete;
+    Result &operator=(const Result &) = delete;
+
+    /* TRUE, if the parsing was successful and the help was not called */
+    explicit operator bool() const { return errorCode == ERR_NONE && !isHelpCalled; }
+
+    bool IsHelpCalled() const { return isHelpCalled; }
+    int ErrorCode() const { return errorCode; } /* Code of error (see scmdp.h) or ERR_NONE */
+    int ErrorIndex() const { return errorIndex; } /* Position of wrong argument in argv */
+
+    /* TRUE, if the optional argument with id (see Spec::Id()) is entered */
+    template <int Id>
+    bool Has() const
+    {
+        static_assert(Id >= 0 && static_cast<std::size_t>(Id) < NumOfOptions, "scmdp: wrong id of optional argument");
+        return optVals[Id] != nullptr;
+    }
+
+    /* Value of optional argument, empty if it's absent ("true" for entered non-valuable argument) */
+    template <int Id>
+    std::string_view Value() const
+    {
+        static_assert(Id >= 0 && static_cast<std::size_t>(Id) < NumOfOptions, "scmdp: wrong id of optional argument");
+        return (optVals[Id] != nullptr) ? std::string_view(optVals[Id]) : std::string_view();
+    }
+
+    /* Value of optional argument converted to integer, nothing if it's absent or it's not a number */
+    template <int Id>
+    std::optional<long long> Integer() const
+    {
+        std::string_view value = Value<Id>();
+        long long number = 0;
+        std::from_chars_result converted = std::from_chars(value.data(), value.data() + value.size(), number);
+
+        if (value.empty() || converted.ec != std::errc() || converted.ptr != value.data() + value.size())
+        {
+            return std::nullopt;
+        }
+        return number;
+    }
+
+    /* Value of non-optional argument by its position */
+    template <int Position>
+    std::string_view Positional() const
+    {
+        static_assert(Position >= 0 && static_cast<std::size_t>(Position) < NumOfPositionals, "scmdp: wrong position of non-optional argument");
+        return (positionals[Position] != nullptr) ? std::string_view(positionals[Position]) : std::string_view();
+    }
+
+private:
+    template <std::size_t, std::size_t>
+    friend class Spec;
+
+    std::array<const char *, NumOfOptions> optVals{}; /* Values of optional arguments by their id, nullptr if absent */
+    std::array<const char *, NumOfPositionals> positionals{}; /* Values of non-optional arguments by their position */
+    bool isHelpCalled = false; /* If TRUE, the help argument was entered */
+    int errorCode = ERR_NONE; /* Code of error of parsing */
+    int errorIndex = 0; /* Position of wrong argument in argv */
+};
+
+/**
+ * Spec of command line. It's made as constexpr, so the key table is built during compilation:
+ * keys are split into buckets by one part of hash and every bucket gets a displacement,
+ * so the keys of bucket get free slots (hash and displace). Lookup is one bucket, one slot and one comparison
+*/
+template <std::size_t NumOfOptions, std::size_t NumOfPositionals>
+class Spec
+{
+public:
+    static constexpr std::size_t maxKeys = 2 * NumOfOptions + 2; /* Two keys per optional argument and help keys */
+    static constexpr std::size_t tableSize = [] { std::size_t size = 4; while (size < 2 * maxKeys) size *= 2; return size; }();
+    static constexpr std::size_t numOfBuckets = tableSize / 4;
+
+    constexpr Spec(std::string_view syntaxHelp, std::string_view descriptHelp, std::string_view longHelpKey, std::string_view shortHelpKey,
+                   const std::array<Option, NumOfOptions> &options, const std::array<Positional, NumOfPositionals> &positionals)
+        : syntaxHelp(syntaxHelp), descriptHelp(descriptHelp), longHelpKey(longHelpKey), shortHelpKey(shortHelpKey),
+          options(options), positionals(positionals)
+    {
+        std::array<std::size_t, numOfBuckets + 1> bucketStarts{};
+        std::array<std::size_t, maxKeys> keysByBucket{};
+        std::array<std::size_t, numOfBuckets> filled{};
+        std::size_t bucket = 0;
+        std::size_t maxSize = 0;
+
+        for (std::size_t i = 0; i < NumOfOptions; i++)
+        {
+            AddKey(options[i].longKey, static_cast<int>(i));
+            AddKey(options[i].shortKey, static_cast<int>(i));
+            numOfValOptions += options[i].valName.empty() ? 0 : 1;
+        }
+        AddKey(longHelpKey, helpId);
+        AddKey(shortHelpKey, helpId);
+
+        /* Keys are grouped by buckets with counting sort */
+        for (std::size_t k = 0; k < numOfKeys; k++)
+        {
+            bucketStarts[BucketOf(hashes[k]) + 1]++;
+        }
+        for (std::size_t b = 0; b < numOfBuckets; b++)
+        {
+            bucketStarts[b + 1] += bucketStarts[b];
+        }
+        for (std::size_t k = 0; k < numOfKeys; k++)
+        {
+            bucket = BucketOf(hashes[k]);
+            keysByBucket[bucketStarts[bucket] + filled[bucket]++] = k;
+        }
+
+        for (std::size_t s = 0; s < tableSize; s++)
+        {
+            slots[s] = -1;
+        }
+
+        /* The biggest buckets are placed first, while the table is almost empty */
+        for (std::size_t b = 0; b < numOfBuckets; b++)
+        {
+            maxSize = (SizeOf(bucketStarts, b) > maxSize) ? SizeOf(bucketStarts, b) : maxSize;
+        }
+        for (std::size_t size = maxSize; size > 0; size--)
+        {
+            for (std::size_t bucket = 0; bucket < numOfBuckets; bucket++)
+            {
+                if (SizeOf(bucketStarts, bucket) == size)
+                {
+                    PlaceBucket(keysByBucket, bucketStarts[bucket], size, bucket);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the id of optional argument by its key during compilation (ex.: constexpr int verbose = spec.Id("--verbose"))
+     *
+     * @returns Id of optional argument or helpId. An unknown key stops the compilation
+     */
+    constexpr int Id(std::string_view key) const
+    {
+        int id = Find(key, HashKey(key));
+
+        if (id == unknownId)
+        {
+            KeyIsUnknown();
+        }
+        return id;
+    }
+
+    /**
+     * @brief Parses the entered arguments, behaves as the parser generated by scmdpgen.
+     * Nothing is printed, the result keeps the code of error
+     *
+     * @param argc The same is argc in int main(...)
+     * @param argv The same is argv[] in int main(...)
+     *
+     * @returns Values of arguments
+     */
+    Result<NumOfOptions, NumOfPositionals> Parse(int argc, char *argv[]) const
+    {
+        Result<NumOfOptions, NumOfPositionals> result;
+        int numOfPositionals = static_cast<int>(NumOfPositionals);
+        int first, last, id;
+        bool optionFirst;
+
+        /* Help keys are compared directly, the comparison stops at the first different character */
+        for (int i = 1; i < argc && hasHelp; i++)
+        {
+            if (IsKey(argv[i], longHelpKey) || IsKey(argv[i], shortHelpKey))
+            {
+                result.isHelpCalled = true;
+                return result;
+            }
+        }
+        if (argc - 1 > numOfPositionals + static_cast<int>(NumOfOptions) + numOfValOptions || argc - 1 < numOfPositionals)
+        {
+            return Fail(result, ERR_WRONG_PARS_NUMBER, argc - 1);
+        }
+
+        /* Non-optional arguments take the end of command line if it starts with an option, otherwise the beginning */
+        optionFirst = (argc > 1 && IsOption(argv[1]));
+        first = optionFirst ? argc - numOfPositionals : 1;
+        for (int i = 0; i < numOfPositionals; i++)
+        {
+            if (IsOption(argv[first + i]))
+            {
+                return Fail(result, ERR_NO_VAL_NOPT_PARAMETER, first + i);
+            }
+            result.positionals[i] = argv[first + i];
+        }
+
+        first = optionFirst ? 1 : numOfPositionals + 1;
+        last = optionFirst ? argc - numOfPositionals : argc;
+        for (int i = first; i < last; i++)
+        {
+            if (optionFirst && !IsOption(argv[i]))
+            {
+                return Fail(result, ERR_WRONG_SYNTAX, i);
+            }
+            id = Match(argv[i]);
+            if (id < 0)
+            {
+                return Fail(result, ERR_UNKNOWN_PARAMETER, i);
+            }
+            if (options[id].valName.empty())
+            {
+                result.optVals[id] = "true";
+            }
+            else if (i + 1 >= last || IsOption(argv[i+1]))
+            {
+                return Fail(result, ERR_NO_VAL_OPT_PARAMETER, i);
+            }
+            else
+            {
+                result.optVals[id] = argv[++i];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Makes the workspace of scmdp with the same arguments, ex.: for console commands or the help.
+     * Values are not bound, the workspace is removed by DeleteWorkspace() or ParseArgs()
+     *
+     * @returns New workspace
+     */
+    ScmdpWorkspace MakeWorkspace() const
+    {
+        ScmdpWorkspace workspace = AddWorkspace(Text(syntaxHelp), Text(descriptHelp));
+
+        if (hasHelp)
+        {
+            AddHelpArg(&workspace, Text(longHelpKey), Text(shortHelpKey));
+        }
+        for (const Option &option : options)
+        {
+            AddOptArg(&workspace, Text(option.longKey), Text(option.shortKey), Text(option.help), Text(option.valName), nullptr);
+        }
+        for (const Positional &positional : positionals)
+        {
+            AddNonOptArg(&workspace, Text(positional.key), Text(positional.help), nullptr);
+        }
+        return workspace;
+    }
+
+    std::string_view syntaxHelp; /* Syntax help string (ex.: USAGE app ARG1 ARG2 [-OPT]) */
+    std::string_view descriptHelp; /* Description of application purpose */
+    std::string_view longHelpKey; /* Long key calling the help, may be empty */
+    std::string_view shortHelpKey; /* Short key calling the help, may be empty */
+    std::array<Option, NumOfOptions> options; /* Optional arguments, their positions are ids */
+    std::array<Positional, NumOfPositionals> positionals; /* Non-optional arguments */
+
+private:
+    /* Two parts of hash choose the bucket and the slot, so the keys of one bucket are scattered over the table */
+    static constexpr std::size_t BucketOf(std::uint64_t hash) { return static_cast<std::size_t>(hash >> 40) & (numOfBuckets - 1); }
+    static constexpr std::size_t SlotOf(std::uint64_t hash, std::uint32_t displacement)
+    {
+        return (static_cast<std::uint32_t>(hash) + displacement * (static_cast<std::uint32_t>(hash >> 32) | 1u)) & (tableSize - 1);
+    }
+    static constexpr bool IsOption(const char *arg) { return *arg == '-' || *arg == '/'; }
+    static bool IsKey(const char *arg, std::string_view key)
+    {
+        std::size_t i = 0;
+
+        for (; i < key.size() && arg[i] == key[i]; i++)
+        {
+        }
+        return !key.empty() && i == key.size() && arg[i] == '\0';
+    }
+    static constexpr std::size_t SizeOf(const std::array<std::size_t, numOfBuckets + 1> &bucketStarts, std::size_t bucket)
+    {
+        return bucketStarts[bucket + 1] - bucketStarts[bucket];
+    }
+
+    /* The first displacement giving free slots to all keys of bucket is taken */
+    constexpr void PlaceBucket(const std::array<std::size_t, maxKeys> &keysByBucket, std::size_t start, std::size_t size, std::size_t bucket)
+    {
+        std::array<std::size_t, maxKeys> bucketSlots{};
+        std::uint32_t displacement = 0;
+
+        while (!FitsTable(keysByBucket, start, size, displacement, bucketSlots))
+        {
+            if (++displacement == 4 * tableSize)
+            {
+                for (std::size_t k = 0; k < size; k++)
+                {
+                    CheckRepeatedKey(keysByBucket[start + k]);
+                }
+                PerfectHashIsNotFound();
+            }
+        }
+        displacements[bucket] = displacement;
+        for (std::size_t k = 0; k < size; k++)
+        {
+            slots[bucketSlots[k]] = static_cast<short>(keysByBucket[start + k]);
+        }
+    }
+
+    /* Slots of keys of bucket must be free and different */
+    constexpr bool FitsTable(const std::array<std::size_t, maxKeys> &keysByBucket, std::size_t start, std::size_t size,
+                             std::uint32_t displacement, std::array<std::size_t, maxKeys> &bucketSlots) const
+    {
+        for (std::size_t k = 0; k < size; k++)
+        {
+            bucketSlots[k] = SlotOf(hashes[keysByBucket[start + k]], displacement);
+            if (slots[bucketSlots[k]] >= 0)
+            {
+                return false;
+            }
+            for (std::size_t j = 0; j < k; j++)
+            {
+                if (bucketSlots[j] == bucketSlots[k])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    static char *Text(std::string_view text) { return const_cast<char *>(text.data() != nullptr ? text.data() : ""); }
+
+    /* Result is moved out, so it's never copied */
+    static Result<NumOfOptions, NumOfPositionals> &&Fail(Result<NumOfOptions, NumOfPositionals> &result, int errorCode, int errorIndex)
+    {
+        result.errorCode = errorCode;
+        result.errorIndex = errorIndex;
+        return std::move(result);
+    }
+
+    constexpr void AddKey(std::string_view key, int id)
+    {
+        if (key.empty())
+        {
+            return;
+        }
+        hasHelp = hasHelp || (id == helpId);
+        keys[numOfKeys] = key;
+        ids[numOfKeys] = id;
+        hashes[numOfKeys] = HashKey(key);
+        numOfKeys++;
+    }
+
+    /* Keys of one bucket which never get different slots have the same hash, it's a repeated key almost always */
+    constexpr void CheckRepeatedKey(std::size_t key) const
+    {
+        for (std::size_t k = 0; k < key; k++)
+        {
+            if (hashes[k] == hashes[key] && keys[k] == keys[key])
+            {
+                KeyIsUsedTwice();
+            }
+        }
+    }
+
+    constexpr int Find(std::string_view key, std::uint64_t hash) const
+    {
+        int k = slots[SlotOf(hash, displacements[BucketOf(hash)])];
+
+        return (k >= 0 && keys[k] == key) ? ids[k] : unknownId;
+    }
+
+    /* The hash and length are counted in one pass over the argument */
+    int Match(const char *arg) const
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        std::size_t length = 0;
+
+        for (; arg[length] != '\0'; length++)
+        {
+            hash ^= static_cast<unsigned char>(arg[length]);
+            hash *= 1099511628211ull;
+        }
+        return Find(std::string_view(arg, length), hash);
+    }
+
+    std::array<std::string_view, maxKeys> keys{}; /* All keys of spec */
+    std::array<int, maxKeys> ids{}; /* Ids of arguments of keys */
+    std::array<std::uint64_t, maxKeys> hashes{}; /* Hashes of keys */
+    std::size_t numOfKeys = 0; /* Number of keys */
+    std::array<std::uint32_t, numOfBuckets> displacements{}; /* Displacement of every bucket */
+    std::array<short, tableSize> slots{}; /* Positions of keys in 'keys' by slot, -1 for empty slot */
+    int numOfValOptions = 0; /* Number of valuable optional arguments */
+    bool hasHelp = false; /* If TRUE, the help argument is set */
+};
+
+/* Spec is made from arrays, their sizes are deduced */
+template <std::size_t NumOfOptions, std::size_t NumOfPositionals>
+Spec(std::string_view, std::string_view, std::string_view, std::string_view,
+     const std::array<Option, NumOfOptions> &, const std::array<Positional, NumOfPositionals> &) -> Spec<NumOfOptions, NumOfPositionals>;
+
+}
+
+/* If scmdp C++ wrapper is not yet connected it will be compiled */
+#endif
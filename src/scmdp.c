@@ -1,14 +1,124 @@
+#ifndef _WIN32
+/* Threads and nanosleep() are needed for the server even with strict C standard, types of directory entries for glob */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#endif
+
 #include <scmdp.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#define read _read
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+/* Counters of server are plain 64-bit integers changed with atomic operations of platform */
+#ifdef _WIN32
+#define SCMDP_ATOMIC_LOAD(place) InterlockedCompareExchange64((place), 0, 0)
+#define SCMDP_ATOMIC_STORE(place, value) InterlockedExchange64((place), (value))
+#define SCMDP_ATOMIC_ADD(place, value) InterlockedExchangeAdd64((place), (value))
+#define SCMDP_ATOMIC_CAS(place, expected, value) (InterlockedCompareExchange64((place), (value), (expected)) == (expected))
+#define SCMDP_ATOMIC_LOAD_POINTER(place) InterlockedCompareExchangePointer((PVOID volatile *)(place), NULL, NULL)
+#define SCMDP_ATOMIC_STORE_POINTER(place, value) InterlockedExchangePointer((PVOID volatile *)(place), (value))
+#define SCMDP_ATOMIC_CAS_POINTER(place, expected, value) (InterlockedCompareExchangePointer((PVOID volatile *)(place), (value), (expected)) == (expected))
+#else
+#define SCMDP_ATOMIC_LOAD(place) __atomic_load_n((place), __ATOMIC_ACQUIRE)
+#define SCMDP_ATOMIC_STORE(place, value) __atomic_store_n((place), (value), __ATOMIC_RELEASE)
+#define SCMDP_ATOMIC_ADD(place, value) __atomic_fetch_add((place), (value), __ATOMIC_ACQ_REL)
+#define SCMDP_ATOMIC_CAS(place, expected, value) __sync_bool_compare_and_swap((place), (expected), (value))
+#define SCMDP_ATOMIC_LOAD_POINTER(place) __atomic_load_n((place), __ATOMIC_ACQUIRE)
+#define SCMDP_ATOMIC_STORE_POINTER(place, value) __atomic_store_n((place), (value), __ATOMIC_RELEASE)
+#define SCMDP_ATOMIC_CAS_POINTER(place, expected, value) __sync_bool_compare_and_swap((place), (expected), (value))
+#endif
+
+/* Eight digits are converted at once by 64-bit arithmetic on little-endian platforms */
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SCMDP_SWAR_DIGITS 1
+#else
+#define SCMDP_SWAR_DIGITS 0
+#endif
+
+/* Help pool of blob begins at a page boundary, so its pages are touched only by the help */
+#define SCMDP_HELP_ALIGNMENT 4096
+
+/* Number of empty polls of queue before the thread starts to sleep between them */
+#define SCMDP_SPIN_LIMIT 64
+
+/* Checks the bit of argument in bitmap made by _ClassifyTokens() */
+#define SCMDP_IS_OPTION(context, i) (((context)->optionBits[(i) >> 6] >> ((i) & 63)) & 1)
+
+/* Marks optional argument in the bitset of entered ones */
+#define SCMDP_MARK_PRESENT(context, id) ((context)->presentBits[(id) >> 6] |= 1ULL << ((id) & 63))
+
+/* Classes of characters in the table of workspace, they are compiled from its syntax profile */
+#define SCMDP_CHAR_PREFIX 1 /* Begins an optional argument, it must be the lowest bit */
+#define SCMDP_CHAR_KEY_END 2 /* Ends the key: '\0' and value separators */
+#define SCMDP_CHAR_TERMINATOR 4 /* Begins '--' if it ends optional arguments */
+
+/* Suffix of size or duration with the number of bytes or nanoseconds it means */
+typedef struct
+{
+    const char *suffix;
+    int length;
+    unsigned long long multiplier;
+} ScmdpUnit;
+
+/* Single letters and IEC suffixes are powers of 1024, SI suffixes with 'B' are powers of 1000 */
+static const ScmdpUnit _sizeUnits[] = {
+    {"", 0, 1ULL}, {"B", 1, 1ULL},
+    {"K", 1, 1ULL << 10}, {"k", 1, 1ULL << 10}, {"KiB", 3, 1ULL << 10}, {"KB", 2, 1000ULL}, {"kB", 2, 1000ULL},
+    {"M", 1, 1ULL << 20}, {"MiB", 3, 1ULL << 20}, {"MB", 2, 1000000ULL},
+    {"G", 1, 1ULL << 30}, {"GiB", 3, 1ULL << 30}, {"GB", 2, 1000000000ULL},
+    {"T", 1, 1ULL << 40}, {"TiB", 3, 1ULL << 40}, {"TB", 2, 1000000000000ULL},
+    {"P", 1, 1ULL << 50}, {"PiB", 3, 1ULL << 50}, {"PB", 2, 1000000000000000ULL},
+    {"E", 1, 1ULL << 60}, {"EiB", 3, 1ULL << 60}, {"EB", 2, 1000000000000000000ULL}
+};
+
+/* Every part of duration needs a unit, the microsecond is also written with the micro sign */
+static const ScmdpUnit _durationUnits[] = {
+    {"ns", 2, 1ULL}, {"us", 2, 1000ULL}, {"\xC2\xB5s", 3, 1000ULL}, {"ms", 2, 1000000ULL},
+    {"s", 1, 1000000000ULL}, {"m", 1, 60000000000ULL}, {"h", 1, 3600000000000ULL}, {"d", 1, 86400000000000ULL}
+};
+
+/* Escapes of characters in JSON strings: 0 for plain ones, 1 for the end of string, 'u' for \u00XX */
+static const unsigned char _jsonEscapes[256] = {
+    1, 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"', ['\\'] = '\\', [127] = 'u'
+};
+
+/* Buffer of caller for JSON, the length is counted even when the buffer is over */
+typedef struct
+{
+    char *buffer;
+    size_t size;
+    size_t length;
+} ScmdpJsonWriter;
+
 /**
  * @brief Issues an error if something went wrong during the parsing
  * 
  * @param workspace Initialized workspace pointer
- * @param errorCode The code of occured error (see 'enum errors' in scmdp.h file)
+ * @param error The occured error (see codes of errors in scmdp.h file)
  * 
  * @returns Nothing
 */
-void _ShowError(ScmdpWorkspace *workspace, int errorCode);
+void _ShowError(ScmdpWorkspace *workspace, ScmdpError *error);
 
 /**
  * @brief Assemble and show the help for all initialized arguments.
@@ -23,329 +133,6027 @@ void _ShowError(ScmdpWorkspace *workspace, int errorCode);
  */
 void _ShowHelp(ScmdpWorkspace *workspace, bool showFullHelp);
 
-/** 
- * @brief Remove the whole workspace with all initialized arguments from memory
+/**
+ * @brief Prints the help text of argument. Every next line of text is indented to the column of its first line
  * 
- * @warning By default this function is called automatically when  function parsearg() ends
+ * @param help Help text, lines are separated by '\n'
+ * @param indent Number of spaces before every next line
+ * 
+ * @return Nothing
+ */
+void _PrintIndentedHelp(char *help, int indent);
+
+/**
+ * @brief Parses the entered arguments into the context. This function is calculation core of this library
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context made for this workspace
+ * @param argc The same is argc in int main(...)
+ * @param argv The same is argv[] in int main(...)
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE.
+ */
+bool _ParseCore(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Clears everything left in the context by the previous parsing
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context made for this workspace
+ * 
+ * @returns Nothing
+ */
+void _ResetParseContext(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Classifies all entered arguments once, so the parsing never looks at their first characters again.
+ * Arguments beginning with option prefix are marked in the bitmap of context,
+ * the positions of the first help key, '--' and response file marker are remembered
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context made for this workspace
+ * @param argc The same is argc in int main(...)
+ * @param argv The same is argv[] in int main(...)
+ * 
+ * @returns Nothing
+ */
+void _ClassifyTokens(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Parses the command line with variadic argument or '--' terminator.
+ * Options go before or after the contiguous block of non-optional values, everything after '--' is non-optional
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context with classified arguments
+ * @param argc The same is argc in int main(...)
+ * @param argv The same is argv[] in int main(...)
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE.
+ */
+bool _ParseRestLayout(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Parses options standing before or after non-optional values, the values are not interleaved with options
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context with classified arguments
+ * @param argv The same is argv[] in int main(...)
+ * @param end End of arguments (argc or position of '--')
+ * @param first Pointer to the position of the first non-optional value
+ * @param last Pointer to the end of non-optional values
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE.
+ */
+bool _ParseOptLayout(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *argv[], int end, int *first, int *last);
+
+/**
+ * @brief Parses one optional argument and its value
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context with classified arguments
+ * @param argv The same is argv[] in int main(...)
+ * @param i Position of optional argument
+ * @param last End of arguments which may be taken as value
+ * 
+ * @returns Position of the last taken argument (i or i+1), 0 if an error occured
+ */
+int _ParseOptArg(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *argv[], int i, int last);
+
+/**
+ * @brief Finds the first argument beginning with option prefix in the bitmap of context, 64 arguments per step
+ * 
+ * @param context Parse context with classified arguments
+ * @param from Position to start from
+ * @param to End of search
+ * 
+ * @returns Position of found argument or 'to' if there is no one
+ */
+int _NextOptionIndex(ScmdpParseContext *context, int from, int to);
+
+/**
+ * @brief Checks the number and lengths of arguments against the budget of workspace.
+ * Lengths are never counted past the limits, so a long argument costs no more than the limit
+ * 
+ * @param workspace Workspace pointer with the budget
+ * @param context Parse context
+ * @param argc The same is argc in int main(...)
+ * @param argv The same is argv[] in int main(...)
+ * 
+ * @return TRUE, if the command line fits the budget. Otherwise, FALSE.
+ */
+bool _CheckBudget(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Builds the table of added keys and the view of overlay
+ * 
+ * @param overlay Initialized overlay pointer
+ * 
+ * @returns Nothing
+ */
+void _CompileOverlay(ScmdpOverlay *overlay);
+
+/**
+ * @brief Matches the key in the table of overlay and then in the table of base, hidden keys of base are not matched
+ * 
+ * @param workspace View of overlay
+ * @param key Entered key
+ * @param length Length of key
+ * @param hash Hash of key
+ * 
+ * @returns Entry of hash table or NULL if it's not a key of overlay
+ */
+ScmdpHotKey *_MatchOverlayKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash);
+
+/**
+ * @brief Checks if the optional argument is hidden by overlay of workspace
+ * 
+ * @param workspace Workspace or view of overlay
+ * @param optId Id of optional argument
+ * 
+ * @returns TRUE, if the argument is hidden. Otherwise, FALSE.
+ */
+bool _IsHidden(ScmdpWorkspace *workspace, int optId);
+
+/**
+ * @brief Checks compiled constraints against the bitset of entered optional arguments.
+ * Every rule costs a few operations per 64 options
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Context of successful parsing
+ * 
+ * @return TRUE, if all constraints are met. Otherwise, FALSE.
+ */
+bool _CheckConstraints(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Calls providers of defaults for absent optional arguments and actions for entered ones.
+ * Defaults of overlay replace the defaults of base, hidden options get no value.
+ * Defaults of typed arguments are converted as entered values
+ * 
+ * @param workspace Compiled workspace pointer with callbacks or view of overlay
+ * @param context Context of successful parsing
+ * 
+ * @return TRUE, if all actions accepted their values and defaults are correct. Otherwise, FALSE.
+ */
+bool _RunOptHooks(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Parses the arguments and makes all values of context: typed values, defaults, actions and glob expansion.
+ * Values are not scattered to the variables
+ * 
+ * @param workspace Compiled workspace pointer or view of overlay
+ * @param context Parse context made for this workspace
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * 
+ * @return TRUE, if the parsing was successful. Otherwise, FALSE.
+ */
+bool _ParseValues(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[]);
+
+/**
+ * @brief Makes the table of callbacks of optional arguments if there's no one yet
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param optId Id of optional argument
+ * 
+ * @returns Callbacks of argument or NULL if there's no such argument
+ */
+ScmdpOptHooks *_GetOptHooks(ScmdpWorkspace *workspace, int optId);
+
+/**
+ * @brief Makes the table of bits and counters of optional arguments if there's no one yet
  * 
  * @param workspace Initialized workspace pointer
+ * @param optId Id of optional argument
+ * 
+ * @returns Output of argument or NULL if there's no such non-valuable argument
+ */
+ScmdpFlagOut *_GetFlagOut(ScmdpWorkspace *workspace, int optId);
+
+/**
+ * @brief Matches the entered argument against the keys. A short key of counter
+ * with repeated last character (ex.: -vvv) is matched too
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param key Entered argument
+ * @param count Pointer to drop the number of entries the argument gives
+ * @param value Pointer to drop the value after separator (ex.: --level=5), NULL if there's no one
+ * 
+ * @returns Entry of hash table or NULL if it's not a key. Non-valuable key with a value is not matched
+ */
+ScmdpHotKey *_MatchArg(ScmdpWorkspace *workspace, char *key, int *count, char **value);
+
+/**
+ * @brief Counts the entries of optional argument and checks them against the budget of workspace
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context
+ * @param optId Id of optional argument
+ * @param count Number of entries
+ * 
+ * @returns TRUE, if the number of entries fits the budget. Otherwise, FALSE.
+ */
+bool _CountEntry(ScmdpWorkspace *workspace, ScmdpParseContext *context, int optId, int count);
+
+/**
+ * @brief Writes the entry of non-valuable optional argument into the context
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context
+ * @param optId Id of optional argument
  * 
  * @returns Nothing
  */
-void _DeleteWorkspace(ScmdpWorkspace *workspace);
+void _MarkFlag(ScmdpWorkspace *workspace, ScmdpParseContext *context, int optId);
 
-ScmdpWorkspace AddWorkspace(char *syntaxHelp, char *description)
-{
-    ScmdpWorkspace newWorkspace;
-    newWorkspace.optArgs = malloc(sizeof(ScmdpOptArg));
-    newWorkspace.nonOptArgs = malloc(sizeof(ScmdpNonOptArg));
-    newWorkspace.numOfNonOptArgs = 0;
-    newWorkspace.numOfOptArgs = 0;
-    newWorkspace.numOfValOptArgs = 0;
-    newWorkspace.helpArg.longHelpKey = "";
-    newWorkspace.helpArg.shortHelpKey = "";
-    newWorkspace.syntaxHelp = syntaxHelp;
-    newWorkspace.descriptHelp = description;
-    return newWorkspace;
-}
+/**
+ * @brief Converts values of typed optional arguments into the arena of context, values converted before are kept
+ * 
+ * @param workspace Compiled workspace pointer with types
+ * @param context Context of successful parsing
+ * @param isDefault If TRUE, values given by defaults to absent arguments are converted, otherwise entered ones
+ * 
+ * @return TRUE, if all values are correct. Otherwise, FALSE.
+ */
+bool _ConvertOptVals(ScmdpWorkspace *workspace, ScmdpParseContext *context, bool isDefault);
 
-void AddHelpArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey)
-{
-    ScmdpHelpArg newHelpArg;
-    newHelpArg.longHelpKey = longKey;
-    newHelpArg.shortHelpKey = shortKey;
-    
-    workspace->helpArg = newHelpArg;
-}
+/**
+ * @brief Parses comma-separated integers and ranges into the arena of context
+ * 
+ * @param context Parse context
+ * @param value String value of argument
+ * @param keepRanges If TRUE, ranges are kept as (start, end) pairs, otherwise they are expanded
+ * 
+ * @returns Number of numbers (or pairs) or -1 if the value is wrong
+ */
+int _ParseNumberList(ScmdpParseContext *context, char *value, bool keepRanges);
+
+/**
+ * @brief Parses size or duration: numbers with optional fraction, each one followed by a unit
+ * 
+ * @param value String value of argument
+ * @param units Table of units
+ * @param numOfUnits Number of units in table
+ * @param isSequence If TRUE, the value may have several parts (ex.: 2h30m), which are summed up
+ * @param number Pointer to drop the result
+ * 
+ * @returns TRUE, if the value is correct and the result fits 63 bits. Otherwise, FALSE.
+ */
+bool _ParseQuantity(char *value, const ScmdpUnit *units, int numOfUnits, bool isSequence, long long *number);
+
+/**
+ * @brief Finds the unit by its suffix
+ * 
+ * @param units Table of units
+ * @param numOfUnits Number of units in table
+ * @param suffix Beginning of suffix
+ * @param length Length of suffix
+ * 
+ * @returns Multiplier of unit or 0 if there's no such unit
+ */
+unsigned long long _MatchUnit(const ScmdpUnit *units, int numOfUnits, char *suffix, int length);
+
+/**
+ * @brief Parses decimal integer with optional '-' sign and moves the cursor after it
+ * 
+ * @param cursor Pointer to the current position in string
+ * @param end End of string
+ * @param number Pointer to drop the integer
+ * 
+ * @returns TRUE, if there are digits and the integer fits 64 bits. Otherwise, FALSE.
+ */
+bool _ParseInteger(char **cursor, char *end, long long *number);
+
+/**
+ * @brief Converts eight decimal digits at once (SWAR)
+ * 
+ * @param digits Eight characters, they are not required to be terminated
+ * @param value Pointer to drop the number
+ * 
+ * @returns TRUE, if all characters are digits. Otherwise, FALSE.
+ */
+bool _ParseEightDigits(const char *digits, unsigned long long *value);
+
+/**
+ * @brief Makes room for numbers in the arena of context
+ * 
+ * @param context Parse context
+ * @param count Number of numbers to add
+ * 
+ * @returns TRUE, if there's room. FALSE, if the arena would exceed SCMDP_MAX_NUMBERS
+ */
+bool _ReserveArena(ScmdpParseContext *context, unsigned long long count);
+
+/**
+ * @brief Finds the optional argument by its long or short key in the key index
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param key Key to search
+ * 
+ * @returns Id of optional argument or -1 if there's no one
+ */
+int _FindOptId(ScmdpWorkspace *workspace, char *key);
+
+/**
+ * @brief Gets the name of optional argument for messages
+ * 
+ * @returns Long key or short key if the long one is empty
+ */
+char *_OptArgName(ScmdpWorkspace *workspace, int id);
+
+/**
+ * @brief Finds the keys nearest to unknown argument by edit distance and writes them to the error of context.
+ * Keys are prefiltered by their lengths kept in the hash table, so the key pool is read only for close keys
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param context Parse context with the error
+ * @param arg Unknown argument
+ * 
+ * @returns Nothing
+ */
+void _SuggestKeys(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *arg);
+
+/**
+ * @brief Counts the edit distance (Levenshtein) between the pattern and the key with Myers' bit-parallel algorithm,
+ * one step per character of key. The counting stops as soon as the distance can't be less than the limit
+ * 
+ * @param peq Bitmasks of positions of every character in the pattern
+ * @param length Length of pattern, 64 at most
+ * @param key Key to compare
+ * @param keyLength Length of key
+ * @param maxDistance Limit of distance
+ * 
+ * @returns Edit distance or (maxDistance + 1) if it's over the limit
+ */
+int _EditDistance(unsigned long long peq[256], int length, const char *key, int keyLength, int maxDistance);
+
+/**
+ * @brief Writes the error to context
+ * 
+ * @param context Parse context pointer
+ * @param errorCode The code of occured error
+ * @param argIndex Position of wrong argument
+ * 
+ * @returns FALSE, so it can be assigned to the parsing result
+ */
+bool _SetParseError(ScmdpParseContext *context, int errorCode, int argIndex);
+
+/**
+ * @brief Shows the help or error message for the failed parsing
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param context Context of failed parsing
+ * 
+ * @returns Nothing
+ */
+void _ShowParseFailure(ScmdpWorkspace *workspace, ScmdpParseContext *context);
 
-void AddOptArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey, char *help, char *valName, char **valPlace)
+/**
+ * @brief Splits the line into words in place
+ * 
+ * @param line Writable line
+ * @param tokens Array for words, it's terminated by NULL as argv
+ * @param maxTokens Maximal number of words
+ * 
+ * @returns Number of words or -1 if there are too many
+ */
+int _SplitLine(char *line, char *tokens[], int maxTokens);
+
+/**
+ * @brief Reads the next line of console with its reader or from its file descriptor.
+ * Too long lines are skipped and counted in 'numOfLongLines' of console, nothing is printed
+ * 
+ * @param console Initialized console pointer
+ * 
+ * @returns Line in the console buffer or NULL if there are no more lines
+ */
+char *_ReadConsoleLine(ScmdpConsole *console);
+
+/**
+ * @brief Finds the command of console by its name
+ * 
+ * @param console Initialized console pointer
+ * @param name The first word of command line
+ * 
+ * @returns Position of command in 'console->commands' or -1 if there's no one
+ */
+int _FindConsoleCommand(ScmdpConsole *console, char *name);
+
+/* Worker of server with its number, it's passed to the thread */
+typedef struct
 {
-    ScmdpOptArg newOptArg;
-    newOptArg.longKey = longKey;
-    newOptArg.shortKey = shortKey;
-    newOptArg.help = help;
-    newOptArg.valPlace = valPlace;
-    newOptArg.valName = valName;
+    ScmdpServer *server;
+    int id;
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} ScmdpServerWorker;
+
+/**
+ * @brief Takes the next line from server queue, splits it, parses it and calls the handler
+ * until the queue is empty and closed
+ * 
+ * @param worker Worker of server
+ * 
+ * @returns Nothing
+ */
+void _RunServerWorker(ScmdpServerWorker *worker);
+
+/**
+ * @brief Entry of worker thread in the form required by platform
+ */
+#ifdef _WIN32
+DWORD WINAPI _ServerThread(LPVOID worker);
+#else
+void *_ServerThread(void *worker);
+#endif
+
+/**
+ * @brief Handles one line of server queue with contexts of the worker
+ * 
+ * @param worker Worker of server
+ * @param line Writable command line
+ * 
+ * @returns Nothing
+ */
+void _ServeLine(ScmdpServerWorker *worker, char *line);
+
+/**
+ * @brief Waits a bit for the other threads. The first polls only yield the processor, the next ones sleep
+ * 
+ * @param numOfPolls Number of empty polls in a row
+ * 
+ * @returns Nothing
+ */
+void _WaitServerQueue(int numOfPolls);
+
+/**
+ * @brief Reads the config file, splits it into words and parses them as optional arguments into the file values
+ * 
+ * @param watch Config watch pointer
+ * @param file Config file
+ * 
+ * @returns TRUE, if the file is read and parsed. Otherwise, FALSE and the file keeps its previous values
+ */
+bool _ReadConfigFile(ScmdpConfigWatch *watch, ScmdpConfigFile *file);
+
+/**
+ * @brief Merges values of all files, compares them with the published ones by option id and publishes
+ * the new snapshot if something is changed. The old snapshot is freed when its readers leave it
+ * 
+ * @param watch Config watch pointer
+ * 
+ * @returns Number of changed options
+ */
+int _PublishConfig(ScmdpConfigWatch *watch);
+
+/**
+ * @brief Reads the time of the last change and size of file
+ * 
+ * @param path Path of file
+ * @param modifyTime Pointer to drop the time
+ * @param size Pointer to drop the size
+ * 
+ * @returns TRUE, if the file exists. Otherwise, FALSE.
+ */
+bool _StatConfigFile(char *path, long long *modifyTime, long long *size);
+
+/* Longest name of directory entry with '\0' on all platforms */
+#define SCMDP_GLOB_NAME_SIZE 261
+
+/* Directory waiting for scanning with the segment of pattern its entries are matched against */
+typedef struct
+{
+    char *path; /* Path of directory with '/' at the end, "" for the current one */
+    int segment; /* Position of segment in the pattern */
+} ScmdpGlobFolder;
+
+/* Scanning of one pattern shared by its threads, the folders and the matches are changed under the lock */
+typedef struct
+{
+    ScmdpGlob *glob;
+    ScmdpParseContext *context;
+    char **segments; /* Parts of pattern between '/' */
+    int numOfSegments;
+    size_t patternLength;
+    ScmdpGlobFolder *folders; /* Stack of directories waiting for scanning */
+    int numOfFolders;
+    int foldersSize;
+    int numOfBusy; /* Number of threads scanning a directory now */
+    long long lock; /* Nonzero while one of threads changes the scanning */
+    int numOfMatches; /* Number of paths matched by the pattern */
+    bool isStopped; /* If TRUE, the handler asked to stop */
+} ScmdpGlobScan;
+
+/**
+ * @brief Expands glob patterns among the values of variadic argument into the path pool of context
+ * or passes all the values to the handler of workspace
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param context Parse context after successful parsing
+ * 
+ * @returns TRUE, if the number of values is still in the limits of variadic argument. Otherwise, FALSE.
+ */
+bool _ExpandRestGlobs(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Scans directories for one pattern with the threads of glob, the calling one included
+ * 
+ * @param glob Glob expansion of workspace
+ * @param context Parse context to keep the matches
+ * @param pattern Glob pattern
+ * 
+ * @returns Number of matches or -1, if the handler asked to stop
+ */
+int _ScanGlob(ScmdpGlob *glob, ScmdpParseContext *context, char *pattern);
+
+/**
+ * @brief Takes directories from the stack of scanning and scans them until the stack is empty
+ * and no other thread may push more
+ * 
+ * @param scan Scanning of pattern
+ * 
+ * @returns Nothing
+ */
+void _RunGlobWorker(ScmdpGlobScan *scan);
+
+/**
+ * @brief Entry of scanning thread in the form required by platform
+ */
+#ifdef _WIN32
+DWORD WINAPI _GlobThread(LPVOID scan);
+#else
+void *_GlobThread(void *scan);
+#endif
+
+/**
+ * @brief Reads the directory and matches its entries against the segment of pattern.
+ * Literal segments are appended to the path without reading directories
+ * 
+ * @param scan Scanning of pattern
+ * @param folder Directory with its segment
+ * 
+ * @returns Nothing
+ */
+void _ScanGlobFolder(ScmdpGlobScan *scan, ScmdpGlobFolder *folder);
+
+/**
+ * @brief Handles the entry of directory matched against the segment: adds it to the matches
+ * if the segment is the last one and pushes it for scanning if it's a directory
+ * 
+ * @param scan Scanning of pattern
+ * @param path Path of directory with room for the name and '/'
+ * @param length Length of path of directory
+ * @param segment Position of segment in the pattern
+ * @param name Name of entry
+ * @param isFolder 1 if entry is a directory, 0 if it isn't, -1 if it's unknown
+ * 
+ * @returns FALSE, if the scanning is stopped. Otherwise, TRUE.
+ */
+bool _AddGlobEntry(ScmdpGlobScan *scan, char *path, size_t length, int segment, char *name, int isFolder);
+
+/**
+ * @brief Pushes the directory to the stack of scanning
+ * 
+ * @param scan Scanning of pattern
+ * @param path Path of directory with '/' at the end
+ * @param length Length of path
+ * @param segment Position of segment its entries are matched against
+ * 
+ * @returns Nothing
+ */
+void _PushGlobFolder(ScmdpGlobScan *scan, char *path, size_t length, int segment);
+
+/**
+ * @brief Passes the matched path to the handler or copies it to the path pool of context
+ * 
+ * @param scan Scanning of pattern
+ * @param path Matched path
+ * 
+ * @returns FALSE, if the scanning is stopped. Otherwise, TRUE.
+ */
+bool _AddGlobPath(ScmdpGlobScan *scan, char *path);
+
+/**
+ * @brief Copies the string to the end of path pool of context, the pool grows if it's needed
+ * 
+ * @param context Parse context
+ * @param path String to copy
+ * 
+ * @returns Nothing
+ */
+void _AddPoolPath(ScmdpParseContext *context, char *path);
+
+/**
+ * @brief Waits until the lock of scanning is taken
+ * 
+ * @param scan Scanning of pattern
+ * 
+ * @returns Nothing
+ */
+void _LockGlobScan(ScmdpGlobScan *scan);
+
+/**
+ * @brief Matches the name against one segment of glob pattern with '*', '?' and classes
+ * 
+ * @param pattern Segment of pattern
+ * @param name Name of directory entry
+ * 
+ * @returns TRUE, if the name is matched. Otherwise, FALSE.
+ */
+bool _MatchGlob(const char *pattern, const char *name);
+
+/**
+ * @brief Matches the character against the class of glob pattern (ex.: [a-z], [!0-9])
+ * 
+ * @param pattern Pattern beginning with '['
+ * @param c Character to match
+ * 
+ * @returns Length of class, if the character is matched; 0, if it isn't; -1, if the class has no ']'
+ */
+int _MatchGlobClass(const char *pattern, char c);
+
+/**
+ * @brief Compares two paths for qsort()
+ * 
+ * @returns Result of strcmp() of paths
+ */
+int _ComparePaths(const void *left, const void *right);
+
+/* Part of command log between line ends parsed by one thread */
+typedef struct
+{
+    ScmdpWorkspace *workspace;
+    ScmdpParseContext context;
+    char *begin; /* The first character of shard in mapped log */
+    char *end; /* Character after the last line end of shard */
+    unsigned long long firstRow; /* Position of the first line of shard in log */
+    unsigned long long numOfRows; /* Number of lines of shard */
+    signed char *status; /* Status column of mapped file, NULL while the lines are counted */
+    unsigned long long columnSize; /* Distance between columns in bytes */
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} ScmdpLogShard;
+
+/**
+ * @brief Runs every shard on its own thread, the first one on the calling thread, and waits for all of them.
+ * A shard whose thread can't be started is run on the calling thread too
+ * 
+ * @param shards Array of shards
+ * @param numOfShards Number of shards
+ * 
+ * @returns Nothing
+ */
+void _RunLogShards(ScmdpLogShard *shards, int numOfShards);
+
+/**
+ * @brief Counts the lines of shard or parses them into the columns if they are already counted
+ * 
+ * @param shard Shard of log
+ * 
+ * @returns Nothing
+ */
+void _RunLogShard(ScmdpLogShard *shard);
+
+/**
+ * @brief Entry of shard thread in the form required by platform
+ */
+#ifdef _WIN32
+DWORD WINAPI _LogThread(LPVOID shard);
+#else
+void *_LogThread(void *shard);
+#endif
+
+/**
+ * @brief Maps the whole file into memory
+ * 
+ * @param path Path of file
+ * @param size Pointer to drop the size of file
+ * @param isWritable If TRUE, the file is made with the given size and mapped for writing, changes go to the file
+ * 
+ * @returns Mapped file, NULL if it can't be mapped or it's empty
+ */
+void *_MapFile(char *path, size_t *size, bool isWritable);
+
+/**
+ * @brief Releases the mapping made by _MapFile()
+ * 
+ * @param data Mapped file
+ * @param size Size of file
+ * 
+ * @returns Nothing
+ */
+void _UnmapFile(void *data, size_t size);
+
+/**
+ * @brief Reads the monotonic clock
+ * 
+ * @returns Time in nanoseconds
+ */
+long long _GetTime(void);
+
+/* Entry of key index with the folded copy of its key, qsort() has no workspace to fold the keys while comparing */
+typedef struct
+{
+    char *folded;
+    ScmdpKeyRef keyRef;
+} ScmdpFoldedKeyRef;
+
+/**
+ * @brief Compares two entries of key index with folded keys for qsort()
+ * 
+ * @returns Result of strcmp() of folded keys or of the keys themselves if folded ones are equal
+ */
+int _CompareKeyRefs(const void *left, const void *right);
+
+/**
+ * @brief Compares the keys as they are matched, by their folded characters (see 'foldedChars' of workspace)
+ * 
+ * @param workspace Workspace pointer with syntax profile
+ * @param left The first key
+ * @param right The second key
+ * @param length Maximal number of characters to compare, (size_t)-1 for whole keys
+ * 
+ * @returns Negative number, 0 or positive number like strncmp()
+ */
+int _CompareFoldedKeys(ScmdpWorkspace *workspace, const char *left, const char *right, size_t length);
+
+/**
+ * @brief Builds the sorted key index of workspace. All long and short keys
+ * of optional arguments and keys of help argument are collected and sorted by their folded characters,
+ * so the keys sharing a prefix make a contiguous range found by binary search.
+ * The first repeated, too long or unknown key of constraint is kept in 'compileError' of workspace, nothing is printed
+ * 
+ * @param workspace Initialized workspace pointer
+ * 
+ * @returns TRUE, if all keys are unique, known and fit the index. Otherwise, FALSE.
+ */
+bool _CompileWorkspace(ScmdpWorkspace *workspace);
+
+/**
+ * @brief Sets the error of workspace which can't be compiled to the context
+ * 
+ * @param workspace Compiled workspace pointer or view of overlay
+ * @param context Parse context of workspace
+ * 
+ * @returns TRUE, if the workspace is compiled without errors. Otherwise, FALSE.
+ */
+bool _CheckCompileError(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Looks for the key in the hash table of keys
+ * 
+ * @param workspace Workspace pointer with the hash table and key pool
+ * @param key String to search
+ * @param length Length of key
+ * @param hash FNV-1a hash of key
+ * 
+ * @returns Entry holding the key or the empty entry where the key goes
+ */
+ScmdpHotKey *_FindHotKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash);
+
+/**
+ * @brief Looks for the key in the cache of the most used keys
+ * 
+ * @param workspace Compiled workspace pointer with the cache
+ * @param key String to search
+ * @param length Length of key
+ * @param hash FNV-1a hash of key
+ * 
+ * @returns Entry of hash table or NULL if the key is not cached
+ */
+ScmdpHotKey *_FindCachedKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash);
+
+/**
+ * @brief Adds the counters of context to the totals of workspace and rebuilds the cache of the most used keys,
+ * unless another parser is rebuilding it now
+ * 
+ * @param workspace Compiled workspace pointer with the cache
+ * @param context Parse context with counters
+ * 
+ * @returns Nothing
+ */
+void _RefreshHotCache(ScmdpWorkspace *workspace, ScmdpParseContext *context);
+
+/**
+ * @brief Matches the entered argument against the keys. The hash and length are counted in one pass,
+ * which stops at the end of argument or at value separator
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param key Entered argument
+ * @param value Pointer to drop the value after separator, NULL if there's no separator
+ * 
+ * @returns Entry of hash table or NULL if it's not a key
+ */
+ScmdpHotKey *_MatchKey(ScmdpWorkspace *workspace, char *key, char **value);
+
+/**
+ * @brief Compares the key of pool with the entered one of the same length, case is ignored if the syntax folds it
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param key Key of pool
+ * @param arg Entered key
+ * @param length Length of both keys
+ * 
+ * @returns TRUE, if the keys are equal. Otherwise, FALSE.
+ */
+bool _EqualKeys(ScmdpWorkspace *workspace, const char *key, const char *arg, int length);
+
+/**
+ * @brief Calculates FNV-1a hash of key with characters folded by the syntax of workspace
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param key Key
+ * @param length Length of key
+ * 
+ * @returns 32-bit hash
+ */
+unsigned int _HashKey(ScmdpWorkspace *workspace, const char *key, int length);
+
+/**
+ * @brief Finds the first entry of key index which is not less than the given key
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param key String to search
+ * 
+ * @returns Position of entry in 'workspace->keyIndex'
+ */
+int _LowerBoundKey(ScmdpWorkspace *workspace, char *key);
+
+/**
+ * @brief Prints all keys beginning with the word under cursor, one per line.
+ * The whole answer is assembled in memory and issued with a single write
+ * 
+ * @param workspace Initialized workspace pointer
+ * @param numOfWords Number of words of edited command line
+ * @param words Words of edited command line (words[0] is the app name)
+ * @param cursor Index of word under cursor
+ * 
+ * @returns Nothing
+ */
+void _ShowCompletions(ScmdpWorkspace *workspace, int numOfWords, char *words[], int cursor);
+
+/**
+ * @brief Builds the escaped JSON names of all arguments, so the serializer only copies them.
+ * Threads may build them at the same time, the names are the same and only the first copy is kept
+ * 
+ * @param workspace Compiled workspace pointer with its arguments
+ * 
+ * @returns Nothing
+ */
+void _BuildJsonKeys(ScmdpWorkspace *workspace);
+
+/**
+ * @brief Appends bytes to JSON
+ * 
+ * @param writer JSON writer
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * 
+ * @returns Nothing
+ */
+void _WriteJson(ScmdpJsonWriter *writer, const char *data, size_t length);
+
+/**
+ * @brief Appends the string to JSON in quotes. Plain characters are copied by runs,
+ * one lookup per character finds both the end of string and the characters to escape
+ * 
+ * @param writer JSON writer
+ * @param value String
+ * 
+ * @returns Nothing
+ */
+void _WriteJsonString(ScmdpJsonWriter *writer, const char *value);
+
+/**
+ * @brief Appends the decimal integer to JSON
+ * 
+ * @param writer JSON writer
+ * @param number Integer
+ * 
+ * @returns Nothing
+ */
+void _WriteJsonNumber(ScmdpJsonWriter *writer, long long number);
+
+/**
+ * @brief Calculates FNV-1a hash of the memory block
+ * 
+ * @param data Pointer to memory
+ * @param size Size of memory in bytes
+ * 
+ * @returns 32-bit hash
+ */
+unsigned int _HashBytes(const void *data, size_t size);
+
+/**
+ * @brief Rounds the size up to the alignment of pointers inside the blob
+ * 
+ * @returns Aligned size
+ */
+size_t _AlignBlobSize(size_t size);
+
+/**
+ * @brief Copies the string to the end of blob string pool
+ * 
+ * @param blob Memory of the blob. Use NULL to only count the pool size
+ * @param poolEnd Current end of string pool, it's moved behind the copied string
+ * @param string String to copy
+ * 
+ * @returns Offset of string to keep in a pointer field, 0 for NULL
+ */
+char *_SaveBlobString(char *blob, size_t *poolEnd, char *string);
+
+/**
+ * @brief Lays out the workspace as a blob and writes it if the memory is given
+ * 
+ * @param workspace Compiled workspace pointer
+ * @param blob Memory of the blob. Use NULL to only calculate the size
+ * 
+ * @returns Size of the blob
+ */
+size_t _WriteBlob(ScmdpWorkspace *workspace, char *blob);
+
+/**
+ * @brief Turns the offset kept in a string field of blob into a pointer
+ * 
+ * @param field String field of blob
+ * @param base Beginning of the blob
+ * @param size Size of the blob
+ * 
+ * @returns TRUE, if the offset lies inside the blob. Otherwise, FALSE.
+ */
+bool _RelocateBlobString(char **field, char *base, size_t size);
+
+#ifndef _WIN32
+/**
+ * @brief Finds the first page of help pool of the mapped blob
+ * 
+ * @param helpOffset Position of help pool in blob
+ * @param size Size of mapping
+ * 
+ * @returns Position of the first page beginning inside the help pool, 'size' if there's none
+ */
+size_t _AlignHelpPages(unsigned long long helpOffset, size_t size);
+#endif
+
+/** 
+ * @brief Remove the whole workspace with all initialized arguments from memory
+ * 
+ * @warning By default this function is called automatically when  function parsearg() ends
+ * 
+ * @param workspace Initialized workspace pointer
+ * 
+ * @returns Nothing
+ */
+void _DeleteWorkspace(ScmdpWorkspace *workspace);
+
+ScmdpWorkspace AddWorkspace(char *syntaxHelp, char *description)
+{
+    ScmdpWorkspace newWorkspace;
+    ScmdpSyntax defaultSyntax = SCMDP_SYNTAX_DEFAULT;
+    newWorkspace.optArgs = malloc(sizeof(ScmdpOptArg));
+    newWorkspace.nonOptArgs = malloc(sizeof(ScmdpNonOptArg));
+    newWorkspace.numOfNonOptArgs = 0;
+    newWorkspace.numOfOptArgs = 0;
+    newWorkspace.numOfValOptArgs = 0;
+    newWorkspace.helpArg.longHelpKey = "";
+    newWorkspace.helpArg.shortHelpKey = "";
+    newWorkspace.restArg.key = "";
+    newWorkspace.restArg.help = "";
+    newWorkspace.restArg.minCount = 0;
+    newWorkspace.restArg.maxCount = 0;
+    newWorkspace.restArg.valPlace = NULL;
+    newWorkspace.restArg.countPlace = NULL;
+    newWorkspace.hasRestArg = false;
+    newWorkspace.syntaxHelp = syntaxHelp;
+    newWorkspace.descriptHelp = description;
+    newWorkspace.completeKey = "";
+    newWorkspace.keyIndex = NULL;
+    newWorkspace.numOfKeys = 0;
+    newWorkspace.hotKeys = NULL;
+    newWorkspace.hotKeysMask = 0;
+    newWorkspace.keyPool = NULL;
+    newWorkspace.keyPoolSize = 0;
+    newWorkspace.isCompiled = false;
+    newWorkspace.compileError = ERR_NONE;
+    newWorkspace.repeatedOptIds[0] = -1;
+    newWorkspace.repeatedOptIds[1] = -1;
+    newWorkspace.optHooks = NULL;
+    newWorkspace.flagOuts = NULL;
+    newWorkspace.optTypes = NULL;
+    newWorkspace.numOfFlagWords = 0;
+    newWorkspace.flagsPlace = NULL;
+    newWorkspace.constraints = malloc(sizeof(ScmdpConstraint));
+    newWorkspace.numOfConstraints = 0;
+    newWorkspace.rules = NULL;
+    newWorkspace.numOfRules = 0;
+    newWorkspace.ruleMasks = NULL;
+    newWorkspace.numOfMaskWords = 0;
+    newWorkspace.budget.maxTokens = 0;
+    newWorkspace.budget.maxTokenLength = 0;
+    newWorkspace.budget.maxTotalBytes = 0;
+    newWorkspace.budget.maxRepeats = 0;
+    newWorkspace.hotCache = NULL;
+    newWorkspace.glob = NULL;
+    newWorkspace.jsonKeys = NULL;
+    newWorkspace.jsonKeyOffsets = NULL;
+    newWorkspace.overlay = NULL;
+    newWorkspace.blob = NULL;
+    newWorkspace.mappedSize = 0;
+    SetSyntaxProfile(&newWorkspace, defaultSyntax);
+    return newWorkspace;
+}
+
+void AddHelpArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey)
+{
+    ScmdpHelpArg newHelpArg;
+    newHelpArg.longHelpKey = longKey;
+    newHelpArg.shortHelpKey = shortKey;
+    
+    workspace->helpArg = newHelpArg;
+    workspace->isCompiled = false;
+}
+
+void AddRestArg(ScmdpWorkspace *workspace, char *key, char *help, int minCount, int maxCount, char ***valPlace, int *countPlace)
+{
+    ScmdpRestArg newRestArg;
+    newRestArg.key = key;
+    newRestArg.help = help;
+    newRestArg.minCount = minCount;
+    newRestArg.maxCount = maxCount;
+    newRestArg.valPlace = valPlace;
+    newRestArg.countPlace = countPlace;
+
+    workspace->restArg = newRestArg;
+    workspace->hasRestArg = true;
+}
+
+void AddCompleteArg(ScmdpWorkspace *workspace, char *key)
+{
+    workspace->completeKey = key;
+}
+
+int AddOptArg(ScmdpWorkspace *workspace, char *longKey, char *shortKey, char *help, char *valName, char **valPlace)
+{
+    ScmdpOptArg newOptArg;
+    newOptArg.longKey = longKey;
+    newOptArg.shortKey = shortKey;
+    newOptArg.help = help;
+    newOptArg.valPlace = valPlace;
+    newOptArg.valName = valName;
+
+    if (strcmp(valName, "") != 0 && valName != NULL)
+    {
+        workspace->numOfValOptArgs += 1;
+        newOptArg.isValuable = true;
+    }
+    else
+    {
+        newOptArg.isValuable = false;
+    }
+
+    workspace->numOfOptArgs += 1;
+    workspace->optArgs = realloc(workspace->optArgs, sizeof(ScmdpOptArg) * workspace->numOfOptArgs);
+    workspace->optArgs[workspace->numOfOptArgs-1] = newOptArg;
+    if (workspace->optHooks != NULL)
+    {
+        workspace->optHooks = realloc(workspace->optHooks, sizeof(ScmdpOptHooks) * workspace->numOfOptArgs);
+        memset(&workspace->optHooks[workspace->numOfOptArgs-1], 0, sizeof(ScmdpOptHooks));
+    }
+    if (workspace->optTypes != NULL)
+    {
+        workspace->optTypes = realloc(workspace->optTypes, sizeof(ScmdpOptType) * workspace->numOfOptArgs);
+        workspace->optTypes[workspace->numOfOptArgs-1].type = SCMDP_TYPE_TEXT;
+        workspace->optTypes[workspace->numOfOptArgs-1].place = NULL;
+    }
+    if (workspace->hotCache != NULL)
+    {
+        workspace->hotCache->totals = realloc(workspace->hotCache->totals, sizeof(long long) * workspace->numOfOptArgs);
+        workspace->hotCache->totals[workspace->numOfOptArgs-1] = 0;
+    }
+    if (workspace->flagOuts != NULL)
+    {
+        workspace->flagOuts = realloc(workspace->flagOuts, sizeof(ScmdpFlagOut) * workspace->numOfOptArgs);
+        workspace->flagOuts[workspace->numOfOptArgs-1].bit = -1;
+        workspace->flagOuts[workspace->numOfOptArgs-1].isCounter = false;
+        workspace->flagOuts[workspace->numOfOptArgs-1].countPlace = NULL;
+    }
+    workspace->isCompiled = false;
+    return workspace->numOfOptArgs-1;
+}
+
+int AddNonOptArg(ScmdpWorkspace *workspace, char *key, char *help, char **valPlace)
+{
+    ScmdpNonOptArg newNonOptArg;
+    newNonOptArg.key = key;
+    newNonOptArg.help = help;
+    newNonOptArg.valPlace = valPlace;
+
+    workspace->numOfNonOptArgs += 1;
+    workspace->nonOptArgs = realloc(workspace->nonOptArgs, sizeof(ScmdpNonOptArg) * workspace->numOfNonOptArgs);
+    workspace->nonOptArgs[workspace->numOfNonOptArgs-1] = newNonOptArg;
+    workspace->isCompiled = false;
+    return workspace->numOfNonOptArgs-1;
+}
+
+void AddConstraint(ScmdpWorkspace *workspace, int kind, char *key, char *otherKeys[], int numOfOtherKeys)
+{
+    ScmdpConstraint newConstraint;
+    newConstraint.kind = kind;
+    newConstraint.group = (workspace->numOfConstraints == 0) ? 0 : workspace->constraints[workspace->numOfConstraints-1].group + 1;
+    newConstraint.key = key;
+
+    /* Every pair of keys is kept separately, the group joins them back into one rule */
+    workspace->constraints = realloc(workspace->constraints, sizeof(ScmdpConstraint) * (workspace->numOfConstraints + numOfOtherKeys + 1));
+    for (int i = 0; i < numOfOtherKeys; i++)
+    {
+        newConstraint.otherKey = otherKeys[i];
+        workspace->constraints[workspace->numOfConstraints++] = newConstraint;
+    }
+    workspace->isCompiled = false;
+}
+
+bool SetOptDefault(ScmdpWorkspace *workspace, int optId, ScmdpDefaultProvider provideDefault, void *userData)
+{
+    ScmdpOptHooks *hooks = _GetOptHooks(workspace, optId);
+
+    if (hooks == NULL)
+    {
+        return false;
+    }
+    hooks->provideDefault = provideDefault;
+    hooks->defaultData = userData;
+    return true;
+}
+
+bool SetOptAction(ScmdpWorkspace *workspace, int optId, ScmdpOptAction action, void *userData)
+{
+    ScmdpOptHooks *hooks = _GetOptHooks(workspace, optId);
+
+    if (hooks == NULL)
+    {
+        return false;
+    }
+    hooks->action = action;
+    hooks->actionData = userData;
+    return true;
+}
+
+bool SetOptFlag(ScmdpWorkspace *workspace, int optId, int bit)
+{
+    ScmdpFlagOut *flagOut = _GetFlagOut(workspace, optId);
+
+    if (flagOut == NULL || bit < -1)
+    {
+        return false;
+    }
+    flagOut->bit = bit;
+    if (bit / 64 + 1 > workspace->numOfFlagWords)
+    {
+        workspace->numOfFlagWords = bit / 64 + 1;
+    }
+    return true;
+}
+
+bool SetOptCounter(ScmdpWorkspace *workspace, int optId, int *countPlace)
+{
+    ScmdpFlagOut *flagOut = _GetFlagOut(workspace, optId);
+
+    if (flagOut == NULL)
+    {
+        return false;
+    }
+    flagOut->isCounter = true;
+    flagOut->countPlace = countPlace;
+    return true;
+}
+
+void BindFlagsPlace(ScmdpWorkspace *workspace, unsigned long long *flagsPlace)
+{
+    workspace->flagsPlace = flagsPlace;
+}
+
+void SetParseBudget(ScmdpWorkspace *workspace, ScmdpBudget budget)
+{
+    workspace->budget = budget;
+}
+
+void SetSyntaxProfile(ScmdpWorkspace *workspace, ScmdpSyntax syntax)
+{
+    memset(workspace->charClasses, 0, sizeof(workspace->charClasses));
+    for (int i = 0; i < 256; i++)
+    {
+        workspace->foldedChars[i] = (syntax.foldCase && i >= 'A' && i <= 'Z') ? (unsigned char)(i - 'A' + 'a') : (unsigned char)i;
+    }
+    for (char *c = syntax.prefixes; c != NULL && *c != '\0'; c++)
+    {
+        workspace->charClasses[(unsigned char)*c] |= SCMDP_CHAR_PREFIX;
+    }
+    for (char *c = syntax.separators; c != NULL && *c != '\0'; c++)
+    {
+        workspace->charClasses[(unsigned char)*c] |= SCMDP_CHAR_KEY_END;
+    }
+    workspace->charClasses[0] |= SCMDP_CHAR_KEY_END;
+    if (syntax.hasTerminator)
+    {
+        workspace->charClasses['-'] |= SCMDP_CHAR_TERMINATOR;
+    }
+
+    /* Hashes of keys depend on case folding, so the table is built again */
+    workspace->isCompiled = false;
+}
+
+void EnableHotKeyCache(ScmdpWorkspace *workspace, int interval)
+{
+    ScmdpHotCache *newCache;
+
+    if (workspace->hotCache == NULL)
+    {
+        /* One more element, so the array is never empty */
+        newCache = calloc(1, sizeof(ScmdpHotCache));
+        newCache->totals = calloc(workspace->numOfOptArgs + 1, sizeof(long long));
+        workspace->hotCache = newCache;
+    }
+    workspace->hotCache->interval = (interval > 0) ? interval : 1;
+}
+
+void EnableRestGlob(ScmdpWorkspace *workspace, int numOfThreads, ScmdpGlobHandler onMatch, void *userData)
+{
+    if (workspace->glob == NULL)
+    {
+        workspace->glob = malloc(sizeof(ScmdpGlob));
+    }
+    workspace->glob->numOfThreads = (numOfThreads > 0) ? numOfThreads : 1;
+    workspace->glob->onMatch = onMatch;
+    workspace->glob->userData = userData;
+}
+
+bool SetOptType(ScmdpWorkspace *workspace, int optId, int type, void *place)
+{
+    if (optId < 0 || optId >= workspace->numOfOptArgs || !workspace->optArgs[optId].isValuable)
+    {
+        return false;
+    }
+    if (workspace->optTypes == NULL)
+    {
+        workspace->optTypes = calloc(workspace->numOfOptArgs, sizeof(ScmdpOptType));
+    }
+    workspace->optTypes[optId].type = type;
+    workspace->optTypes[optId].place = place;
+    return true;
+}
+
+bool ParseArgs(ScmdpWorkspace *workspace, int argc, char *argv[])
+{
+    ScmdpParseContext context;
+    bool success;
+    char *cursorEnd;
+    long cursor;
+
+    /* Completion mode is requested by the shell on every TAB press, so it goes before everything else */
+    if (argc > 2 && *workspace->completeKey != '\0' && strcmp(argv[1], workspace->completeKey) == 0)
+    {
+        /* The cursor comes from the shell, but it's still a word of command line, so it must point into the words or just after them */
+        cursor = strtol(argv[2], &cursorEnd, 10);
+        if (*argv[2] != '\0' && *cursorEnd == '\0' && cursor >= 0 && cursor <= argc - 3)
+        {
+            _ShowCompletions(workspace, argc - 3, argv + 3, (int)cursor);
+        }
+        _DeleteWorkspace(workspace);
+        return false;
+    }
+
+    context = AddParseContext(workspace);
+    success = ParseArgsInContext(workspace, &context, argc, argv);
+    if (!success)
+    {
+        _ShowParseFailure(workspace, &context);
+    }
+    else
+    {
+        /* Typed values point into the arena and expanded paths into the pool, so they live as long as argv does */
+        context.arena = NULL;
+        context.pathPool = NULL;
+        context.globVals = NULL;
+        context.joinedVals = NULL;
+    }
+
+    /** Now release the memory! 
+     * Everything is scattered into variables or error message was issued
+     * We don't need workspace anymore! */
+    DeleteParseContext(&context);
+    _DeleteWorkspace(workspace);
+    return success;
+}
+
+ScmdpParseContext AddParseContext(ScmdpWorkspace *workspace)
+{
+    ScmdpParseContext newContext;
+
+    if (!workspace->isCompiled)
+    {
+        _CompileWorkspace(workspace);
+    }
+
+    /* One more element, so the arrays are never empty */
+    newContext.optVals = malloc(sizeof(char *) * (workspace->numOfOptArgs + 1));
+    newContext.nonOptVals = malloc(sizeof(char *) * (workspace->numOfNonOptArgs + 1));
+    newContext.restVals = NULL;
+    newContext.numOfRestVals = 0;
+    newContext.numOfOptArgs = workspace->numOfOptArgs;
+    newContext.numOfNonOptArgs = workspace->numOfNonOptArgs;
+    newContext.isHelpCalled = false;
+    newContext.error.code = ERR_NONE;
+    newContext.error.argIndex = 0;
+    newContext.error.optId = -1;
+    newContext.error.otherOptId = -1;
+    newContext.error.numOfSuggestions = 0;
+    /* Repeated key is reported once, here, and every parsing in the context fails with the same error */
+    _CheckCompileError(workspace, &newContext);
+    newContext.presentBits = malloc(sizeof(unsigned long long) * workspace->numOfMaskWords);
+    newContext.flagBits = calloc(workspace->numOfFlagWords + 1, sizeof(unsigned long long));
+    newContext.optCounts = calloc(workspace->numOfOptArgs + 1, 1);
+    newContext.typedVals = calloc(workspace->numOfOptArgs + 1, sizeof(ScmdpNumbers));
+    newContext.arena = NULL;
+    newContext.arenaSize = 0;
+    newContext.arenaUsed = 0;
+    /* Bitmap fits the longest correct command line from the start */
+    newContext.optionBitsSize = (workspace->numOfNonOptArgs + workspace->numOfOptArgs + workspace->numOfValOptArgs + 1) / 64 + 1;
+    newContext.optionBits = malloc(sizeof(unsigned long long) * newContext.optionBitsSize);
+    newContext.helpIndex = 0;
+    newContext.terminatorIndex = 0;
+    newContext.responseIndex = 0;
+    newContext.matchCounts = (workspace->hotCache != NULL) ? calloc(workspace->numOfOptArgs + 1, sizeof(unsigned int)) : NULL;
+    newContext.numOfTracked = 0;
+    newContext.pathPool = NULL;
+    newContext.pathPoolSize = 0;
+    newContext.pathPoolUsed = 0;
+    newContext.pathOffsets = NULL;
+    newContext.globVals = NULL;
+    newContext.numOfPaths = 0;
+    newContext.pathsSize = 0;
+    newContext.joinedVals = NULL;
+    newContext.joinedValsSize = 0;
+    return newContext;
+}
+
+bool ParseArgsInContext(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    bool success = _ParseValues(workspace, context, argc, argv);
+
+    /* Values are scattered only after successful parsing, so variables never get a half of command line */
+    if (success)
+    {
+        for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+        {
+            if (workspace->nonOptArgs[i].valPlace != NULL)
+            {
+                *(workspace->nonOptArgs[i].valPlace) = context->nonOptVals[i];
+            }
+        }
+        for (int i = 0; i < workspace->numOfOptArgs; i++)
+        {
+            if (workspace->optArgs[i].valPlace != NULL && context->optVals[i] != NULL)
+            {
+                *(workspace->optArgs[i].valPlace) = context->optVals[i];
+            }
+        }
+        for (int i = 0; workspace->overlay != NULL && i < workspace->overlay->added.numOfOptArgs; i++)
+        {
+            if (workspace->overlay->added.optArgs[i].valPlace != NULL && context->optVals[workspace->numOfOptArgs + i] != NULL)
+            {
+                *(workspace->overlay->added.optArgs[i].valPlace) = context->optVals[workspace->numOfOptArgs + i];
+            }
+        }
+        if (workspace->hasRestArg && workspace->restArg.valPlace != NULL)
+        {
+            *(workspace->restArg.valPlace) = context->restVals;
+        }
+        if (workspace->hasRestArg && workspace->restArg.countPlace != NULL)
+        {
+            *(workspace->restArg.countPlace) = context->numOfRestVals;
+        }
+        if (workspace->flagsPlace != NULL)
+        {
+            memcpy(workspace->flagsPlace, context->flagBits, sizeof(unsigned long long) * workspace->numOfFlagWords);
+        }
+        for (int i = 0; workspace->optTypes != NULL && i < workspace->numOfOptArgs; i++)
+        {
+            if (workspace->optTypes[i].place == NULL)
+            {
+                continue;
+            }
+            if (workspace->optTypes[i].type == SCMDP_TYPE_INT_LIST || workspace->optTypes[i].type == SCMDP_TYPE_RANGE_LIST)
+            {
+                *(ScmdpNumbers *)workspace->optTypes[i].place = context->typedVals[i];
+            }
+            else if (workspace->optTypes[i].type != SCMDP_TYPE_TEXT && context->typedVals[i].count > 0)
+            {
+                *(long long *)workspace->optTypes[i].place = context->typedVals[i].values[0];
+            }
+        }
+        for (int i = 0; workspace->flagOuts != NULL && i < workspace->numOfOptArgs; i++)
+        {
+            if (workspace->flagOuts[i].countPlace != NULL)
+            {
+                *(workspace->flagOuts[i].countPlace) = context->optCounts[i];
+            }
+        }
+    }
+    return success;
+}
+
+size_t FormatParseResult(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *buffer, size_t bufferSize, int format)
+{
+    ScmdpJsonWriter writer = {buffer, bufferSize, 0};
+    ScmdpWorkspace *named = (workspace->overlay != NULL) ? workspace->overlay->base : workspace;
+    ScmdpWorkspace *added = (workspace->overlay != NULL) ? &workspace->overlay->added : NULL;
+    unsigned int *offsets;
+    char *keys;
+    int numOfOptArgs = workspace->numOfOptArgs;
+    size_t skip = 1;
+    int k;
+
+    /* Names are not needed to parse, so they are made on demand and loaded workspace stays without allocation. View of overlay takes the names of its base */
+    if (SCMDP_ATOMIC_LOAD_POINTER(&named->jsonKeys) == NULL)
+    {
+        _BuildJsonKeys(named);
+    }
+    if (added != NULL && SCMDP_ATOMIC_LOAD_POINTER(&added->jsonKeys) == NULL)
+    {
+        _BuildJsonKeys(added);
+    }
+    keys = named->jsonKeys;
+    offsets = named->jsonKeyOffsets;
+
+    _WriteJson(&writer, "{", 1);
+    if (context->isHelpCalled)
+    {
+        _WriteJson(&writer, "\"help\":true", 11);
+    }
+    else if (context->error.code != ERR_NONE)
+    {
+        _WriteJson(&writer, "\"error\":", 8);
+        _WriteJsonNumber(&writer, context->error.code);
+        _WriteJson(&writer, ",\"argIndex\":", 12);
+        _WriteJsonNumber(&writer, context->error.argIndex);
+    }
+    else
+    {
+        /* Names begin with comma, it's skipped for the first one */
+        for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+        {
+            k = numOfOptArgs + i;
+            _WriteJson(&writer, keys + offsets[k] + skip, offsets[k+1] - offsets[k] - skip);
+            skip = 0;
+            if (context->nonOptVals[i] != NULL)
+            {
+                _WriteJsonString(&writer, context->nonOptVals[i]);
+            }
+            else
+            {
+                _WriteJson(&writer, "null", 4);
+            }
+        }
+        if (workspace->hasRestArg)
+        {
+            k = numOfOptArgs + workspace->numOfNonOptArgs;
+            _WriteJson(&writer, keys + offsets[k] + skip, offsets[k+1] - offsets[k] - skip);
+            skip = 0;
+            _WriteJson(&writer, "[", 1);
+            for (int i = 0; i < context->numOfRestVals; i++)
+            {
+                if (i > 0)
+                {
+                    _WriteJson(&writer, ",", 1);
+                }
+                _WriteJsonString(&writer, context->restVals[i]);
+            }
+            _WriteJson(&writer, "]", 1);
+        }
+        for (int i = 0; i < numOfOptArgs; i++)
+        {
+            if (context->optVals[i] == NULL)
+            {
+                continue;
+            }
+            _WriteJson(&writer, keys + offsets[i] + skip, offsets[i+1] - offsets[i] - skip);
+            skip = 0;
+            if (workspace->optArgs[i].isValuable)
+            {
+                _WriteJsonString(&writer, context->optVals[i]);
+            }
+            else if (workspace->flagOuts != NULL && workspace->flagOuts[i].isCounter)
+            {
+                _WriteJsonNumber(&writer, context->optCounts[i]);
+            }
+            else
+            {
+                _WriteJson(&writer, "true", 4);
+            }
+        }
+        for (int i = 0; added != NULL && i < added->numOfOptArgs; i++)
+        {
+            if (context->optVals[numOfOptArgs + i] == NULL)
+            {
+                continue;
+            }
+            _WriteJson(&writer, added->jsonKeys + added->jsonKeyOffsets[i] + skip, added->jsonKeyOffsets[i+1] - added->jsonKeyOffsets[i] - skip);
+            skip = 0;
+            if (added->optArgs[i].isValuable)
+            {
+                _WriteJsonString(&writer, context->optVals[numOfOptArgs + i]);
+            }
+            else
+            {
+                _WriteJson(&writer, "true", 4);
+            }
+        }
+    }
+    _WriteJson(&writer, "}\n", (format == SCMDP_FORMAT_NDJSON) ? 2 : 1);
+    if (writer.length < bufferSize)
+    {
+        buffer[writer.length] = '\0';
+    }
+    return writer.length;
+}
+
+void DeleteParseContext(ScmdpParseContext *context)
+{
+    free(context->optVals);
+    free(context->nonOptVals);
+    free(context->optionBits);
+    free(context->presentBits);
+    free(context->flagBits);
+    free(context->optCounts);
+    free(context->typedVals);
+    free(context->arena);
+    free(context->matchCounts);
+    free(context->pathPool);
+    free(context->pathOffsets);
+    free(context->globVals);
+    free(context->joinedVals);
+    context->matchCounts = NULL;
+    context->pathPool = NULL;
+    context->pathPoolSize = 0;
+    context->pathOffsets = NULL;
+    context->globVals = NULL;
+    context->pathsSize = 0;
+    context->joinedVals = NULL;
+    context->joinedValsSize = 0;
+    context->presentBits = NULL;
+    context->flagBits = NULL;
+    context->optCounts = NULL;
+    context->typedVals = NULL;
+    context->arena = NULL;
+    context->arenaSize = 0;
+    context->optVals = NULL;
+    context->nonOptVals = NULL;
+    context->optionBits = NULL;
+    context->optionBitsSize = 0;
+}
+
+void DeleteWorkspace(ScmdpWorkspace *workspace)
+{
+    _DeleteWorkspace(workspace);
+}
+
+ScmdpOverlay AddOverlay(ScmdpWorkspace *base)
+{
+    ScmdpOverlay newOverlay;
+
+    newOverlay.base = base;
+    newOverlay.added = AddWorkspace(base->syntaxHelp, base->descriptHelp);
+    newOverlay.hiddenIds = NULL;
+    newOverlay.numOfHidden = 0;
+    newOverlay.defaults = NULL;
+    newOverlay.numOfDefaults = 0;
+    newOverlay.view = *base;
+    newOverlay.view.overlay = NULL;
+    newOverlay.isCompiled = false;
+    return newOverlay;
+}
+
+int AddOverlayOptArg(ScmdpOverlay *overlay, char *longKey, char *shortKey, char *help, char *valName, char **valPlace)
+{
+    overlay->isCompiled = false;
+    return overlay->base->numOfOptArgs + AddOptArg(&overlay->added, longKey, shortKey, help, valName, valPlace);
+}
+
+bool HideOverlayOptArg(ScmdpOverlay *overlay, int optId)
+{
+    int i;
+
+    if (optId < 0 || optId >= overlay->base->numOfOptArgs)
+    {
+        return false;
+    }
+    /* The view may be not built yet, so the id is looked for in the list of overlay itself */
+    for (i = 0; i < overlay->numOfHidden; i++)
+    {
+        if (overlay->hiddenIds[i] == optId)
+        {
+            return true;
+        }
+    }
+
+    /* Ids are kept sorted, so the parser finds them by binary search */
+    overlay->hiddenIds = realloc(overlay->hiddenIds, sizeof(int) * (overlay->numOfHidden + 1));
+    for (i = overlay->numOfHidden; i > 0 && overlay->hiddenIds[i-1] > optId; i--)
+    {
+        overlay->hiddenIds[i] = overlay->hiddenIds[i-1];
+    }
+    overlay->hiddenIds[i] = optId;
+    overlay->numOfHidden++;
+    return true;
+}
+
+bool SetOverlayDefault(ScmdpOverlay *overlay, int optId, ScmdpDefaultProvider provideDefault, void *userData)
+{
+    int numOfBaseOpts = overlay->base->numOfOptArgs;
+    ScmdpOptArg *optArg;
+    ScmdpOverlayDefault newDefault;
+
+    if (optId < 0 || optId >= numOfBaseOpts + overlay->added.numOfOptArgs)
+    {
+        return false;
+    }
+    optArg = (optId < numOfBaseOpts) ? &overlay->base->optArgs[optId] : &overlay->added.optArgs[optId - numOfBaseOpts];
+    if (!optArg->isValuable)
+    {
+        return false;
+    }
+
+    newDefault.optId = optId;
+    newDefault.provideDefault = provideDefault;
+    newDefault.defaultData = userData;
+    overlay->defaults = realloc(overlay->defaults, sizeof(ScmdpOverlayDefault) * (overlay->numOfDefaults + 1));
+    overlay->defaults[overlay->numOfDefaults++] = newDefault;
+    return true;
+}
+
+ScmdpParseContext AddOverlayContext(ScmdpOverlay *overlay)
+{
+    ScmdpParseContext newContext;
+    int numOfOptArgs;
+
+    if (!overlay->isCompiled)
+    {
+        _CompileOverlay(overlay);
+    }
+
+    /* Values of added options follow the values of base options */
+    newContext = AddParseContext(&overlay->view);
+    numOfOptArgs = overlay->view.numOfOptArgs + overlay->added.numOfOptArgs;
+    newContext.numOfOptArgs = numOfOptArgs;
+    newContext.optVals = realloc(newContext.optVals, sizeof(char *) * (numOfOptArgs + 1));
+    newContext.optCounts = realloc(newContext.optCounts, numOfOptArgs + 1);
+    newContext.typedVals = realloc(newContext.typedVals, sizeof(ScmdpNumbers) * (numOfOptArgs + 1));
+    newContext.presentBits = realloc(newContext.presentBits, sizeof(unsigned long long) * (numOfOptArgs / 64 + 1));
+    memset(newContext.optCounts, 0, numOfOptArgs + 1);
+    memset(newContext.typedVals, 0, sizeof(ScmdpNumbers) * (numOfOptArgs + 1));
+    return newContext;
+}
+
+bool ParseArgsInOverlay(ScmdpOverlay *overlay, ScmdpParseContext *context, int argc, char *argv[])
+{
+    return ParseArgsInContext(&overlay->view, context, argc, argv);
+}
+
+void DeleteOverlay(ScmdpOverlay *overlay)
+{
+    DeleteWorkspace(&overlay->added);
+    free(overlay->hiddenIds);
+    free(overlay->defaults);
+    overlay->hiddenIds = NULL;
+    overlay->defaults = NULL;
+    overlay->numOfHidden = 0;
+    overlay->numOfDefaults = 0;
+    overlay->view.overlay = NULL;
+    overlay->isCompiled = false;
+}
+
+void _CompileOverlay(ScmdpOverlay *overlay)
+{
+    ScmdpWorkspace *base = overlay->base;
+    ScmdpWorkspace *added = &overlay->added;
+
+    if (!base->isCompiled)
+    {
+        _CompileWorkspace(base);
+    }
+
+    /* Added keys follow the syntax of base, their ids follow the ids of base options */
+    memcpy(added->charClasses, base->charClasses, sizeof(added->charClasses));
+    memcpy(added->foldedChars, base->foldedChars, sizeof(added->foldedChars));
+    _CompileWorkspace(added);
+    for (int i = 0; i <= added->hotKeysMask; i++)
+    {
+        if (added->hotKeys[i].length != 0 && added->hotKeys[i].id >= 0)
+        {
+            added->hotKeys[i].id += base->numOfOptArgs;
+        }
+    }
+
+    /**
+    *   View shares all arrays of base. Cache of base is not used, its positions don't know the overlay.
+    *   Valuable added options are counted with the valuable options of base, the parser counts the added options themselves
+    */
+    overlay->view = *base;
+    overlay->view.overlay = overlay;
+    overlay->view.hotCache = NULL;
+    overlay->view.numOfValOptArgs += added->numOfValOptArgs;
+    if (overlay->view.compileError == ERR_NONE && added->compileError != ERR_NONE)
+    {
+        overlay->view.compileError = added->compileError;
+        overlay->view.repeatedOptIds[0] = added->repeatedOptIds[0] + ((added->repeatedOptIds[0] >= 0) ? base->numOfOptArgs : 0);
+        overlay->view.repeatedOptIds[1] = added->repeatedOptIds[1] + ((added->repeatedOptIds[1] >= 0) ? base->numOfOptArgs : 0);
+    }
+    overlay->isCompiled = true;
+}
+
+ScmdpHotKey *_MatchOverlayKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash)
+{
+    ScmdpHotKey *hotKey = _FindHotKey(&workspace->overlay->added, key, length, hash);
+
+    /* Small table of overlay is looked at first, so its keys replace the same keys of base */
+    if (hotKey->length != 0)
+    {
+        return hotKey;
+    }
+    hotKey = _FindHotKey(workspace, key, length, hash);
+    return (hotKey->length != 0 && !_IsHidden(workspace, hotKey->id)) ? hotKey : NULL;
+}
+
+bool _IsHidden(ScmdpWorkspace *workspace, int optId)
+{
+    int left = 0;
+    int right;
+    int middle;
+
+    if (workspace->overlay == NULL)
+    {
+        return false;
+    }
+    right = workspace->overlay->numOfHidden;
+    while (left < right)
+    {
+        middle = left + (right - left) / 2;
+        if (workspace->overlay->hiddenIds[middle] < optId)
+        {
+            left = middle + 1;
+        }
+        else
+        {
+            right = middle;
+        }
+    }
+    return left < workspace->overlay->numOfHidden && workspace->overlay->hiddenIds[left] == optId;
+}
+
+bool _ParseValues(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    bool success = _ParseCore(workspace, context, argc, argv);
+
+    if (success && workspace->optTypes != NULL)
+    {
+        success = _ConvertOptVals(workspace, context, false);
+    }
+    if (success && (workspace->optHooks != NULL || workspace->overlay != NULL))
+    {
+        success = _RunOptHooks(workspace, context);
+    }
+    if (success && workspace->glob != NULL && workspace->hasRestArg)
+    {
+        success = _ExpandRestGlobs(workspace, context);
+    }
+    return success;
+}
+
+bool _ParseCore(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    bool optArgFound = false;
+    bool success = true;    
+    int count;
+    char *value;
+    /* Options added by overlay are not in the arrays of view, but they may be entered */
+    int numOfOptArgs = workspace->numOfOptArgs + ((workspace->overlay != NULL) ? workspace->overlay->added.numOfOptArgs : 0);
+
+    /* Counters of context are reported once in a while, so parsers rarely touch the shared totals */
+    if (context->matchCounts != NULL && ++context->numOfTracked >= workspace->hotCache->interval)
+    {
+        _RefreshHotCache(workspace, context);
+    }
+
+    _ResetParseContext(workspace, context);
+
+    /* Workspace with a repeated key is not parsed, its keys would be taken by the wrong options */
+    if (!_CheckCompileError(workspace, context))
+    {
+        return false;
+    }
+
+    /* Command line over the budget is rejected before any work on its arguments */
+    if (!_CheckBudget(workspace, context, argc, argv))
+    {
+        return false;
+    }
+
+    /* Every argument is looked at once, the rest of parsing uses the bitmap of context */
+    _ClassifyTokens(workspace, context, argc, argv);
+
+    /**
+    *   First you need to check if there is an argument that calls the help.
+    *   If it is present, then we mark it in context and caller shows the help
+    */
+    if (context->helpIndex != 0)
+    {
+        context->isHelpCalled = true;
+        success = false;
+    }
+    /* The number of non-optional values may vary, so they are found by position of options */
+    else if (workspace->hasRestArg || context->terminatorIndex != 0)
+    {
+        success = _ParseRestLayout(workspace, context, argc, argv);
+    }
+    /* If help was not called, we go to analyze all the entered arguments */
+    else if (argc-1 > workspace->numOfNonOptArgs + numOfOptArgs + workspace->numOfValOptArgs)
+    {
+        success = _SetParseError(context, ERR_WRONG_PARS_NUMBER, argc - 1);
+    }
+    else if (argc-1 < workspace->numOfNonOptArgs)
+    {
+        success = _SetParseError(context, ERR_WRONG_PARS_NUMBER, argc - 1);
+    }
+    else if (argc == 1)
+    {
+        /* Nothing is entered and nothing is needed */
+    }
+    else
+    {   
+        /**
+        *   Check if the first argument is optional or not 
+        * 
+        *   You can choose the notation by yourself (for example '@') with SetSyntaxProfile()
+        *   By default there are presents UNIX notation '-' and Windows notation '/'
+        */
+        if (SCMDP_IS_OPTION(context, 1))
+        {
+            /* If the first argument is optional, we go from the end to parse non-optional at first */
+            for (int i = argc - 1; i > argc - workspace->numOfNonOptArgs - 1; i--)
+            {
+                if (SCMDP_IS_OPTION(context, i))
+                {
+                    success = _SetParseError(context, ERR_NO_VAL_NOPT_PARAMETER, i);
+                    break;
+                }
+                else
+                {
+                    context->nonOptVals[i - argc + workspace->numOfNonOptArgs] = argv[i];
+                }
+            }
+            /* After non-optional arguments if parsing was succesful we come back to begin and parse optional ones */
+            if (success)
+            {
+                for(int i = 1; i < argc - workspace->numOfNonOptArgs; i++)
+                {
+                    if (SCMDP_IS_OPTION(context, i))
+                    {
+                        /* Hash table has every key once, so only one argument takes the value */
+                        ScmdpHotKey *hotKey = _MatchArg(workspace, argv[i], &count, &value);
+                        int j = (hotKey != NULL) ? hotKey->id : -1;
+                        optArgFound = (j >= 0);
+                        if (optArgFound && !_CountEntry(workspace, context, j, count))
+                        {
+                            success = _SetParseError(context, ERR_OVER_BUDGET, i);
+                            break;
+                        }
+                        if (optArgFound)
+                        {
+                            if(hotKey->isValuable)
+                            {
+                                if (value != NULL)
+                                {
+                                    /* Value is attached to the key by separator (ex.: --level=5) */
+                                    context->optVals[j] = value;
+                                    SCMDP_MARK_PRESENT(context, j);
+                                }
+                                else if((i + 1 > argc - workspace->numOfNonOptArgs - 1) || SCMDP_IS_OPTION(context, i+1))
+                                {
+                                    success = _SetParseError(context, ERR_NO_VAL_OPT_PARAMETER, i);
+                                }
+                                else
+                                {
+                                    context->optVals[j] = argv[i+1];
+                                    SCMDP_MARK_PRESENT(context, j);
+                                    ++i;
+                                }
+                            }
+                            else
+                            {
+                                _MarkFlag(workspace, context, j);
+                            }
+                        }
+                        if(success)
+                        {
+                            if (!optArgFound)
+                            {
+                                success = _SetParseError(context, ERR_UNKNOWN_PARAMETER, i);
+                                _SuggestKeys(workspace, context, argv[i]);
+                                break;
+                            }
+                        }
+                        else
+                        {
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        success = _SetParseError(context, ERR_WRONG_SYNTAX, i);
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            /* If the first argument is non-optional, we go parse arguments in direct order */
+            for (int i = 1; i < workspace->numOfNonOptArgs+1; i++)
+            {
+                if (SCMDP_IS_OPTION(context, i))
+                {
+                    success = _SetParseError(context, ERR_NO_VAL_NOPT_PARAMETER, i);
+                    break;
+                }
+                else
+                {
+                    context->nonOptVals[i-1] = argv[i];
+                }
+            }
+            if (success)
+            {
+                /* Separate loop for parsing optional arguments in direct order */
+                for (int i = workspace->numOfNonOptArgs+1; i < argc; i++)
+                {
+                    ScmdpHotKey *hotKey = _MatchArg(workspace, argv[i], &count, &value);
+                    int j = (hotKey != NULL) ? hotKey->id : -1;
+                    optArgFound = (j >= 0);
+                    if (optArgFound && !_CountEntry(workspace, context, j, count))
+                    {
+                        success = _SetParseError(context, ERR_OVER_BUDGET, i);
+                        break;
+                    }
+                    if (optArgFound)
+                    {
+                        if(hotKey->isValuable)
+                        {
+                            if (value != NULL)
+                            {
+                                context->optVals[j] = value;
+                                SCMDP_MARK_PRESENT(context, j);
+                            }
+                            else if((i+1 >= argc) || SCMDP_IS_OPTION(context, i+1))
+                            {
+                                success = _SetParseError(context, ERR_NO_VAL_OPT_PARAMETER, i);
+                            }
+                            else
+                            {
+                                context->optVals[j] = argv[i+1];
+                                SCMDP_MARK_PRESENT(context, j);
+                                ++i;
+                            }
+                        }
+                        else
+                        {
+                            _MarkFlag(workspace, context, j);
+                        }
+                    }
+                    if(success)
+                    {
+                        if (!optArgFound)
+                        {
+                            success = _SetParseError(context, ERR_UNKNOWN_PARAMETER, i);
+                            _SuggestKeys(workspace, context, argv[i]);
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Combinations of optional arguments are checked when all of them are known */
+    if (success && workspace->numOfRules > 0)
+    {
+        success = _CheckConstraints(workspace, context);
+    }
+    return success;
+}    
+
+void _ResetParseContext(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    /* Context keeps nothing from the previous parsing */
+    memset(context->optVals, 0, sizeof(char *) * context->numOfOptArgs);
+    memset(context->nonOptVals, 0, sizeof(char *) * context->numOfNonOptArgs);
+    context->restVals = NULL;
+    context->numOfRestVals = 0;
+    context->isHelpCalled = false;
+    context->error.code = ERR_NONE;
+    context->error.argIndex = 0;
+    context->error.optId = -1;
+    context->error.otherOptId = -1;
+    context->error.numOfSuggestions = 0;
+    memset(context->presentBits, 0, sizeof(unsigned long long) * (context->numOfOptArgs / 64 + 1));
+    memset(context->optCounts, 0, context->numOfOptArgs);
+    if (workspace->flagOuts != NULL)
+    {
+        memset(context->flagBits, 0, sizeof(unsigned long long) * workspace->numOfFlagWords);
+    }
+    if (workspace->optTypes != NULL)
+    {
+        memset(context->typedVals, 0, sizeof(ScmdpNumbers) * context->numOfOptArgs);
+        context->arenaUsed = 0;
+    }
+}
+
+bool _CheckBudget(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    ScmdpBudget *budget = &workspace->budget;
+    size_t limit, length;
+    long long total = 0;
+
+    if (budget->maxTokens > 0 && argc - 1 > budget->maxTokens)
+    {
+        return _SetParseError(context, ERR_OVER_BUDGET, budget->maxTokens + 1);
+    }
+    if (budget->maxTokenLength <= 0 && budget->maxTotalBytes <= 0)
+    {
+        return true;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        /* One byte over the limit is enough to see it's exceeded */
+        limit = (budget->maxTokenLength > 0) ? (size_t)budget->maxTokenLength + 1 : (size_t)-1;
+        if (budget->maxTotalBytes > 0 && (size_t)(budget->maxTotalBytes - total) + 1 < limit)
+        {
+            limit = (size_t)(budget->maxTotalBytes - total) + 1;
+        }
+        length = strnlen(argv[i], limit);
+        total += (long long)length;
+        if ((budget->maxTokenLength > 0 && length > (size_t)budget->maxTokenLength) ||
+            (budget->maxTotalBytes > 0 && total > budget->maxTotalBytes))
+        {
+            return _SetParseError(context, ERR_OVER_BUDGET, i);
+        }
+    }
+    return true;
+}
+
+void _ClassifyTokens(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    unsigned long long word = 0;
+    unsigned char first;
+    unsigned char isOption;
+    unsigned char longHelpFirst = workspace->foldedChars[(unsigned char)*workspace->helpArg.longHelpKey];
+    unsigned char shortHelpFirst = workspace->foldedChars[(unsigned char)*workspace->helpArg.shortHelpKey];
+    size_t longHelpLength = strlen(workspace->helpArg.longHelpKey);
+    size_t shortHelpLength = strlen(workspace->helpArg.shortHelpKey);
+    size_t length;
+
+    if (argc / 64 + 1 > context->optionBitsSize)
+    {
+        context->optionBitsSize = argc / 64 + 1;
+        context->optionBits = realloc(context->optionBits, sizeof(unsigned long long) * context->optionBitsSize);
+    }
+    context->helpIndex = 0;
+    context->terminatorIndex = 0;
+    context->responseIndex = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        /* Everything after '--' is a value, even if it looks like an option or the help key */
+        first = (unsigned char)*argv[i];
+        isOption = (context->terminatorIndex == 0) ? workspace->charClasses[first] & SCMDP_CHAR_PREFIX : 0;
+        word |= (unsigned long long)isOption << (i & 63);
+        if ((i & 63) == 63)
+        {
+            context->optionBits[i >> 6] = word;
+            word = 0;
+        }
+
+        /* Rare kinds of arguments are recognized by the first character before full comparison, argv[0] is not an argument */
+        if (i == 0 || context->terminatorIndex != 0)
+        {
+            continue;
+        }
+        if (context->helpIndex == 0 && (workspace->foldedChars[first] == longHelpFirst || workspace->foldedChars[first] == shortHelpFirst))
+        {
+            length = strlen(argv[i]);
+            if ((length == longHelpLength && _EqualKeys(workspace, workspace->helpArg.longHelpKey, argv[i], (int)length))
+                || (length == shortHelpLength && _EqualKeys(workspace, workspace->helpArg.shortHelpKey, argv[i], (int)length)))
+            {
+                context->helpIndex = i;
+            }
+        }
+        if (context->terminatorIndex == 0 && (workspace->charClasses[first] & SCMDP_CHAR_TERMINATOR) && argv[i][1] == '-' && argv[i][2] == '\0')
+        {
+            context->terminatorIndex = i;
+        }
+        if (context->responseIndex == 0 && first == '@')
+        {
+            context->responseIndex = i;
+        }
+    }
+    context->optionBits[argc >> 6] = word;
+}
+
+bool _ParseRestLayout(ScmdpWorkspace *workspace, ScmdpParseContext *context, int argc, char *argv[])
+{
+    int minCount = workspace->numOfNonOptArgs;
+    int maxCount = workspace->numOfNonOptArgs;
+    int end = (context->terminatorIndex != 0) ? context->terminatorIndex : argc;
+    int numOfBefore, numOfAfter, numOfRest;
+    int first, last, i;
+
+    if (workspace->hasRestArg)
+    {
+        minCount += workspace->restArg.minCount;
+        maxCount = (workspace->restArg.maxCount < 0) ? argc : maxCount + workspace->restArg.maxCount;
+    }
+
+    /* Before '--' options stand as without it, all after it is non-optional and follows the values before it */
+    if (!_ParseOptLayout(workspace, context, argv, end, &first, &last))
+    {
+        return false;
+    }
+    numOfBefore = last - first;
+    numOfAfter = (context->terminatorIndex != 0) ? argc - context->terminatorIndex - 1 : 0;
+    if (numOfBefore + numOfAfter < minCount || numOfBefore + numOfAfter > maxCount)
+    {
+        return _SetParseError(context, ERR_WRONG_PARS_NUMBER, numOfBefore + numOfAfter);
+    }
+    for (i = 0; i < workspace->numOfNonOptArgs; i++)
+    {
+        context->nonOptVals[i] = (i < numOfBefore) ? argv[first + i] : argv[end + 1 + i - numOfBefore];
+    }
+
+    /* The rest of values is not copied if it lies on one side of '--', context points inside argv */
+    numOfRest = numOfBefore + numOfAfter - workspace->numOfNonOptArgs;
+    context->numOfRestVals = numOfRest;
+    if (numOfAfter == 0 || numOfBefore >= workspace->numOfNonOptArgs + numOfRest)
+    {
+        context->restVals = argv + first + workspace->numOfNonOptArgs;
+    }
+    else if (numOfBefore <= workspace->numOfNonOptArgs)
+    {
+        context->restVals = argv + end + 1 + workspace->numOfNonOptArgs - numOfBefore;
+    }
+    else
+    {
+        if (numOfRest > context->joinedValsSize)
+        {
+            context->joinedValsSize = numOfRest;
+            context->joinedVals = realloc(context->joinedVals, sizeof(char *) * numOfRest);
+        }
+        memcpy(context->joinedVals, argv + first + workspace->numOfNonOptArgs, sizeof(char *) * (numOfBefore - workspace->numOfNonOptArgs));
+        memcpy(context->joinedVals + numOfBefore - workspace->numOfNonOptArgs, argv + end + 1, sizeof(char *) * numOfAfter);
+        context->restVals = context->joinedVals;
+    }
+    return true;
+}
+
+bool _ParseOptLayout(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *argv[], int end, int *first, int *last)
+{
+    int i;
+
+    if (end > 1 && SCMDP_IS_OPTION(context, 1))
+    {
+        /* Options go first, non-optional values begin with the first argument which is not an option or its value */
+        for (i = 1; i < end && SCMDP_IS_OPTION(context, i); i++)
+        {
+            i = _ParseOptArg(workspace, context, argv, i, end);
+            if (i == 0)
+            {
+                return false;
+            }
+        }
+        *first = i;
+        *last = end;
+        i = _NextOptionIndex(context, *first, end);
+        if (i != end)
+        {
+            return _SetParseError(context, ERR_WRONG_SYNTAX, i);
+        }
+    }
+    else
+    {
+        /* Non-optional values go first up to the first option */
+        *first = 1;
+        *last = _NextOptionIndex(context, 1, end);
+        for (i = *last; i < end; i++)
+        {
+            if (!SCMDP_IS_OPTION(context, i))
+            {
+                return _SetParseError(context, ERR_WRONG_SYNTAX, i);
+            }
+            i = _ParseOptArg(workspace, context, argv, i, end);
+            if (i == 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int _ParseOptArg(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *argv[], int i, int last)
+{
+    int count;
+    char *value;
+    ScmdpHotKey *hotKey = _MatchArg(workspace, argv[i], &count, &value);
+    int j = (hotKey != NULL) ? hotKey->id : -1;
+
+    if (j < 0)
+    {
+        _SetParseError(context, ERR_UNKNOWN_PARAMETER, i);
+        _SuggestKeys(workspace, context, argv[i]);
+        return 0;
+    }
+    if (!_CountEntry(workspace, context, j, count))
+    {
+        _SetParseError(context, ERR_OVER_BUDGET, i);
+        return 0;
+    }
+    if (!hotKey->isValuable)
+    {
+        _MarkFlag(workspace, context, j);
+        return i;
+    }
+    if (value != NULL)
+    {
+        /* Value is attached to the key by separator (ex.: --level=5) */
+        context->optVals[j] = value;
+        SCMDP_MARK_PRESENT(context, j);
+        return i;
+    }
+    if (i + 1 >= last || SCMDP_IS_OPTION(context, i+1))
+    {
+        _SetParseError(context, ERR_NO_VAL_OPT_PARAMETER, i);
+        return 0;
+    }
+    context->optVals[j] = argv[i+1];
+    SCMDP_MARK_PRESENT(context, j);
+    return i + 1;
+}
+
+int _NextOptionIndex(ScmdpParseContext *context, int from, int to)
+{
+    unsigned long long word;
+
+    for (int i = from; i < to; i = (i | 63) + 1)
+    {
+        word = context->optionBits[i >> 6] >> (i & 63);
+        if (word != 0)
+        {
+            while ((word & 1) == 0)
+            {
+                word >>= 1;
+                i++;
+            }
+            return (i < to) ? i : to;
+        }
+    }
+    return to;
+}
+
+void _SuggestKeys(ScmdpWorkspace *workspace, ScmdpParseContext *context, char *arg)
+{
+    unsigned long long peq[256] = {0};
+    unsigned long long foldedPeq[256] = {0};
+    int distances[SCMDP_MAX_SUGGESTIONS];
+    ScmdpError *error = &context->error;
+    int length = 0;
+    int maxDistance, distance, j;
+    ScmdpWorkspace *tables[2] = {workspace, (workspace->overlay != NULL) ? &workspace->overlay->added : NULL};
+    ScmdpHotKey *hotKey;
+    char *key;
+
+    /* Value after separator is not a part of key */
+    while (!(workspace->charClasses[(unsigned char)arg[length]] & SCMDP_CHAR_KEY_END))
+    {
+        length++;
+    }
+    if (length == 0 || length > 64)
+    {
+        return;
+    }
+    /* Short arguments get only one change, the longer ones three at most */
+    maxDistance = 1 + length / 4;
+    maxDistance = (maxDistance < 3) ? maxDistance : 3;
+    for (int i = 0; i < length; i++)
+    {
+        foldedPeq[workspace->foldedChars[(unsigned char)arg[i]]] |= 1ULL << i;
+    }
+    /* Every character matches the positions of its folded form, so case is ignored if the syntax folds it */
+    for (int i = 0; i < 256; i++)
+    {
+        peq[i] = foldedPeq[workspace->foldedChars[i]];
+    }
+
+    /* Keys added by overlay are looked at too, the hidden keys of base are not suggested */
+    for (int t = 0; t < 2 && tables[t] != NULL; t++)
+    {
+        for (int i = 0; i <= tables[t]->hotKeysMask; i++)
+        {
+            hotKey = &tables[t]->hotKeys[i];
+            if (hotKey->length == 0 || hotKey->length > length + maxDistance || hotKey->length + maxDistance < length)
+            {
+                continue;
+            }
+            if (t == 0 && hotKey->id >= 0 && _IsHidden(workspace, hotKey->id))
+            {
+                continue;
+            }
+            key = tables[t]->keyPool + hotKey->offset;
+            distance = _EditDistance(peq, length, key, hotKey->length, maxDistance);
+            if (distance > maxDistance)
+            {
+                continue;
+            }
+
+            /* The nearest keys are kept sorted by distance and then by key, so the order doesn't depend on hashes */
+            j = error->numOfSuggestions;
+            while (j > 0 && (distances[j-1] > distance || (distances[j-1] == distance && strcmp(error->suggestions[j-1], key) > 0)))
+            {
+                if (j < SCMDP_MAX_SUGGESTIONS)
+                {
+                    distances[j] = distances[j-1];
+                    error->suggestions[j] = error->suggestions[j-1];
+                }
+                j--;
+            }
+            if (j < SCMDP_MAX_SUGGESTIONS)
+            {
+                distances[j] = distance;
+                error->suggestions[j] = key;
+                if (error->numOfSuggestions < SCMDP_MAX_SUGGESTIONS)
+                {
+                    error->numOfSuggestions++;
+                }
+            }
+        }
+    }
+}
+
+int _EditDistance(unsigned long long peq[256], int length, const char *key, int keyLength, int maxDistance)
+{
+    unsigned long long last = 1ULL << (length - 1);
+    unsigned long long vp = (length == 64) ? ~0ULL : (1ULL << length) - 1;
+    unsigned long long vn = 0;
+    unsigned long long eq, xv, xh, ph, mh;
+    int distance = length;
+
+    for (int i = 0; i < keyLength; i++)
+    {
+        eq = peq[(unsigned char)key[i]];
+        xv = eq | vn;
+        xh = (((eq & vp) + vp) ^ vp) | eq;
+        ph = vn | ~(xh | vp);
+        mh = vp & xh;
+        if (ph & last)
+        {
+            distance++;
+        }
+        else if (mh & last)
+        {
+            distance--;
+        }
+        /* The first row of matrix grows by one with every character of key */
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        vp = mh | ~(xv | ph);
+        vn = ph & xv;
+        /* Every next character lowers the distance by one at most */
+        if (distance - (keyLength - i - 1) > maxDistance)
+        {
+            return maxDistance + 1;
+        }
+    }
+    return distance;
+}
+
+bool _SetParseError(ScmdpParseContext *context, int errorCode, int argIndex)
+{
+    context->error.code = errorCode;
+    context->error.argIndex = argIndex;
+    return false;
+}
+
+void _ShowParseFailure(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    if (context->isHelpCalled)
+    {
+        _ShowHelp(workspace, true);
+    }
+    else if (context->error.code == ERR_WRONG_PARS_NUMBER)
+    {
+        _ShowHelp(workspace, false);
+    }
+    else if (context->error.code != ERR_NONE)
+    {
+        _ShowError(workspace, &context->error);
+    }
+}
+
+size_t SaveWorkspace(ScmdpWorkspace *workspace, void *buffer, size_t bufferSize)
+{
+    size_t size;
+
+    if (!workspace->isCompiled)
+    {
+        _CompileWorkspace(workspace);
+    }
+    if (workspace->compileError != ERR_NONE)
+    {
+        return 0;
+    }
+
+    /* Loaded workspace may keep offsets of help text yet */
+    LoadHelpText(workspace);
+    size = _WriteBlob(workspace, NULL);
+    if (buffer != NULL && size <= bufferSize)
+    {
+        /* Padding between sections is hashed too, so it must be defined */
+        memset(buffer, 0, size);
+        _WriteBlob(workspace, buffer);
+    }
+    return size;
+}
+
+bool SaveWorkspaceFile(ScmdpWorkspace *workspace, char *path)
+{
+    FILE *file;
+    void *blob;
+    size_t size;
+    bool success = false;
+
+    size = SaveWorkspace(workspace, NULL, 0);
+    if (size == 0)
+    {
+        return false;
+    }
+    blob = malloc(size);
+    SaveWorkspace(workspace, blob, size);
+
+    file = fopen(path, "wb");
+    if (file != NULL)
+    {
+        success = (fwrite(blob, 1, size, file) == size);
+        success = (fclose(file) == 0) && success;
+    }
+    free(blob);
+    return success;
+}
+
+bool LoadWorkspace(ScmdpWorkspace *workspace, void *blob, size_t size)
+{
+    ScmdpBlobHeader *header = blob;
+    ScmdpWorkspace *loaded;
+    char *base = blob;
+    size_t offset;
+    bool success = true;
+
+    if (size < _AlignBlobSize(sizeof(ScmdpBlobHeader)) + sizeof(ScmdpWorkspace))
+    {
+        return false;
+    }
+    if (header->magic != SCMDP_BLOB_MAGIC || header->version != SCMDP_BLOB_VERSION || header->pointerSize != sizeof(void *))
+    {
+        return false;
+    }
+    if (header->size > size || header->size < _AlignBlobSize(sizeof(ScmdpBlobHeader)) + sizeof(ScmdpWorkspace) ||
+        header->helpOffset > header->size || header->helpOffset < _AlignBlobSize(sizeof(ScmdpBlobHeader)) + sizeof(ScmdpWorkspace))
+    {
+        return false;
+    }
+    size = (size_t)header->size;
+    loaded = (ScmdpWorkspace *)(base + _AlignBlobSize(sizeof(ScmdpBlobHeader)));
+
+    /* The blob which is already fixed up at the same address can be loaded again as it is */
+    if (header->relocatedBase != (unsigned long long)(size_t)base)
+    {
+        if (header->relocatedBase != 0 || header->helpState != 0 ||
+            header->checksum != _HashBytes(base + sizeof(ScmdpBlobHeader), header->helpOffset - sizeof(ScmdpBlobHeader)))
+        {
+            return false;
+        }
+
+        offset = (size_t)loaded->optArgs;
+        success = success && offset + sizeof(ScmdpOptArg) * loaded->numOfOptArgs <= size;
+        loaded->optArgs = (ScmdpOptArg *)(base + offset);
+        offset = (size_t)loaded->nonOptArgs;
+        success = success && offset + sizeof(ScmdpNonOptArg) * loaded->numOfNonOptArgs <= size;
+        loaded->nonOptArgs = (ScmdpNonOptArg *)(base + offset);
+        offset = (size_t)loaded->keyIndex;
+        success = success && offset + sizeof(ScmdpKeyRef) * loaded->numOfKeys <= size;
+        loaded->keyIndex = (ScmdpKeyRef *)(base + offset);
+        offset = (size_t)loaded->hotKeys;
+        success = success && offset + sizeof(ScmdpHotKey) * ((size_t)loaded->hotKeysMask + 1) <= size;
+        loaded->hotKeys = (ScmdpHotKey *)(base + offset);
+        offset = (size_t)loaded->keyPool;
+        success = success && offset + loaded->keyPoolSize <= size;
+        loaded->keyPool = base + offset;
+        offset = (size_t)loaded->rules;
+        success = success && offset + sizeof(ScmdpRule) * loaded->numOfRules <= size;
+        loaded->rules = (ScmdpRule *)(base + offset);
+        offset = (size_t)loaded->ruleMasks;
+        success = success && offset + sizeof(unsigned long long) * loaded->numOfRules * loaded->numOfMaskWords <= size;
+        loaded->ruleMasks = (unsigned long long *)(base + offset);
+        if (!success)
+        {
+            return false;
+        }
+
+        success = success && _RelocateBlobString(&loaded->completeKey, base, size);
+        success = success && _RelocateBlobString(&loaded->helpArg.longHelpKey, base, size);
+        success = success && _RelocateBlobString(&loaded->helpArg.shortHelpKey, base, size);
+        success = success && _RelocateBlobString(&loaded->restArg.key, base, size);
+        for (int i = 0; i < loaded->numOfOptArgs && success; i++)
+        {
+            success = success && _RelocateBlobString(&loaded->optArgs[i].longKey, base, size);
+            success = success && _RelocateBlobString(&loaded->optArgs[i].shortKey, base, size);
+        }
+        for (int i = 0; i < loaded->numOfNonOptArgs && success; i++)
+        {
+            success = success && _RelocateBlobString(&loaded->nonOptArgs[i].key, base, size);
+        }
+        for (int i = 0; i < loaded->numOfKeys && success; i++)
+        {
+            success = success && _RelocateBlobString(&loaded->keyIndex[i].key, base, size);
+        }
+        if (!success)
+        {
+            return false;
+        }
+        header->relocatedBase = (unsigned long long)(size_t)base;
+    }
+
+    *workspace = *loaded;
+    workspace->blob = blob;
+    workspace->mappedSize = 0;
+    return true;
+}
+
+bool LoadWorkspaceFile(ScmdpWorkspace *workspace, char *path)
+{
+    void *blob = NULL;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file, mapping;
+    LARGE_INTEGER fileSize;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    if (GetFileSizeEx(file, &fileSize))
+    {
+        size = (size_t)fileSize.QuadPart;
+        mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (mapping != NULL)
+        {
+            /* Copy-on-write view, fixed up pages become private */
+            blob = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    if (blob == NULL)
+    {
+        return false;
+    }
+    if (!LoadWorkspace(workspace, blob, size))
+    {
+        UnmapViewOfFile(blob);
+        return false;
+    }
+#else
+    struct stat fileStat;
+    ScmdpBlobHeader header;
+    size_t helpStart;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        size = (size_t)fileStat.st_size;
+        /* Private writable mapping, only pages touched by fix-ups are copied */
+        blob = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+        /**
+        *   Pages of help pool get no access until the help before anything is read, otherwise the kernel
+        *   may map them together with the keys. The header is read from the file for it, not from the mapping
+        */
+        if (blob != MAP_FAILED && pread(file, &header, sizeof(ScmdpBlobHeader), 0) == sizeof(ScmdpBlobHeader) &&
+            header.magic == SCMDP_BLOB_MAGIC && header.helpState == 0)
+        {
+            helpStart = _AlignHelpPages(header.helpOffset, size);
+            if (helpStart < size)
+            {
+                mprotect((char *)blob + helpStart, size - helpStart, PROT_NONE);
+            }
+        }
+    }
+    close(file);
+    if (blob == NULL || blob == MAP_FAILED)
+    {
+        return false;
+    }
+    if (!LoadWorkspace(workspace, blob, size))
+    {
+        munmap(blob, size);
+        return false;
+    }
+#endif
+    workspace->mappedSize = size;
+    return true;
+}
+
+void LoadHelpText(ScmdpWorkspace *workspace)
+{
+    ScmdpBlobHeader *header = workspace->blob;
+    ScmdpWorkspace *loaded;
+    char *base = workspace->blob;
+    size_t size;
+#ifndef _WIN32
+    size_t helpStart;
+#endif
+    bool success;
+    int numOfPolls = 0;
+
+    if (header == NULL)
+    {
+        return;
+    }
+    loaded = (ScmdpWorkspace *)(base + _AlignBlobSize(sizeof(ScmdpBlobHeader)));
+
+    /* One thread fixes up the help pool, the others wait for it */
+    if (SCMDP_ATOMIC_CAS(&header->helpState, 0, 1))
+    {
+        size = (size_t)header->size;
+#ifndef _WIN32
+        helpStart = _AlignHelpPages(header->helpOffset, workspace->mappedSize);
+        if (helpStart < workspace->mappedSize)
+        {
+            mprotect(base + helpStart, workspace->mappedSize - helpStart, PROT_READ | PROT_WRITE);
+        }
+#endif
+        success = (header->helpChecksum == _HashBytes(base + header->helpOffset, size - header->helpOffset));
+        success = success && _RelocateBlobString(&loaded->syntaxHelp, base, size);
+        success = success && _RelocateBlobString(&loaded->descriptHelp, base, size);
+        success = success && _RelocateBlobString(&loaded->restArg.help, base, size);
+        for (int i = 0; i < loaded->numOfOptArgs && success; i++)
+        {
+            success = success && _RelocateBlobString(&loaded->optArgs[i].valName, base, size);
+            success = success && _RelocateBlobString(&loaded->optArgs[i].help, base, size);
+        }
+        for (int i = 0; i < loaded->numOfNonOptArgs && success; i++)
+        {
+            success = success && _RelocateBlobString(&loaded->nonOptArgs[i].help, base, size);
+        }
+        if (!success)
+        {
+            /* Broken help text is not a reason to fail, it's just not shown */
+            loaded->syntaxHelp = "";
+            loaded->descriptHelp = "";
+            loaded->restArg.help = "";
+            for (int i = 0; i < loaded->numOfOptArgs; i++)
+            {
+                loaded->optArgs[i].valName = "";
+                loaded->optArgs[i].help = "";
+            }
+            for (int i = 0; i < loaded->numOfNonOptArgs; i++)
+            {
+                loaded->nonOptArgs[i].help = "";
+            }
+        }
+        SCMDP_ATOMIC_STORE(&header->helpState, 2);
+    }
+    while (SCMDP_ATOMIC_LOAD(&header->helpState) != 2)
+    {
+        _WaitServerQueue(numOfPolls++);
+    }
+
+    /* Workspace and its copies (ex.: view of overlay) keep their own fields, arrays are shared with the blob */
+    workspace->syntaxHelp = loaded->syntaxHelp;
+    workspace->descriptHelp = loaded->descriptHelp;
+    workspace->restArg.help = loaded->restArg.help;
+}
+
+bool BindValPlace(ScmdpWorkspace *workspace, char *key, char **valPlace)
+{
+    int found;
+
+    if (!workspace->isCompiled)
+    {
+        _CompileWorkspace(workspace);
+    }
+
+    found = _LowerBoundKey(workspace, key);
+    if (found < workspace->numOfKeys && _CompareFoldedKeys(workspace, workspace->keyIndex[found].key, key, (size_t)-1) == 0)
+    {
+        if (workspace->keyIndex[found].id == SCMDP_HELP_ID)
+        {
+            return false;
+        }
+        workspace->optArgs[workspace->keyIndex[found].id].valPlace = valPlace;
+        return true;
+    }
+
+    for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+    {
+        if (strcmp(workspace->nonOptArgs[i].key, key) == 0)
+        {
+            workspace->nonOptArgs[i].valPlace = valPlace;
+            return true;
+        }
+    }
+    return false;
+}
+
+long long ParseLogFile(ScmdpWorkspace *workspace, char *logPath, char *columnsPath, int numOfThreads)
+{
+    ScmdpLogShard *shards;
+    ScmdpColumnsHeader *header;
+    char *log;
+    char *lineEnd;
+    size_t logSize = (size_t)-1;
+    size_t columnsSize;
+    size_t position;
+    unsigned long long numOfRows = 0;
+    unsigned long long columnSize;
+    int numOfShards = (numOfThreads > 0) ? numOfThreads : 1;
+
+    /* Size is left as it is if the file can't be opened, an empty file is mapped to NULL */
+    log = _MapFile(logPath, &logSize, false);
+    if (log == NULL && logSize > 0)
+    {
+        return -1;
+    }
+
+    /* Every shard ends right after a line end, so no line is split between threads */
+    shards = malloc(sizeof(ScmdpLogShard) * numOfShards);
+    for (int i = 0; i < numOfShards; i++)
+    {
+        shards[i].workspace = workspace;
+        shards[i].context = AddParseContext(workspace);
+        shards[i].begin = (i == 0) ? log : shards[i-1].end;
+        position = (size_t)((unsigned long long)logSize * (i + 1) / numOfShards);
+        if (position < (size_t)(shards[i].begin - log))
+        {
+            position = shards[i].begin - log;
+        }
+        lineEnd = (position > 0 && position < logSize) ? memchr(log + position - 1, '\n', logSize - position + 1) : NULL;
+        shards[i].end = (lineEnd != NULL) ? lineEnd + 1 : log + logSize;
+        if (i == numOfShards - 1)
+        {
+            shards[i].end = log + logSize;
+        }
+        shards[i].status = NULL;
+    }
+
+    /* Lines are counted first, so every thread writes its rows straight into the mapped columns */
+    _RunLogShards(shards, numOfShards);
+    for (int i = 0; i < numOfShards; i++)
+    {
+        shards[i].firstRow = numOfRows;
+        numOfRows += shards[i].numOfRows;
+    }
+    columnSize = (numOfRows + 63) & ~63ULL;
+    columnsSize = 64 + (size_t)columnSize * (workspace->numOfOptArgs + 1);
+
+    header = _MapFile(columnsPath, &columnsSize, true);
+    if (header != NULL)
+    {
+        header->magic = SCMDP_COLUMNS_MAGIC;
+        header->version = SCMDP_COLUMNS_VERSION;
+        header->numOfRows = numOfRows;
+        header->columnSize = columnSize;
+        header->numOfOptArgs = workspace->numOfOptArgs;
+        header->headerSize = 64;
+        for (int i = 0; i < numOfShards; i++)
+        {
+            shards[i].status = (signed char *)header + 64;
+            shards[i].columnSize = columnSize;
+        }
+        _RunLogShards(shards, numOfShards);
+        _UnmapFile(header, columnsSize);
+    }
+
+    for (int i = 0; i < numOfShards; i++)
+    {
+        DeleteParseContext(&shards[i].context);
+    }
+    free(shards);
+    if (log != NULL)
+    {
+        _UnmapFile(log, logSize);
+    }
+    return (header != NULL) ? (long long)numOfRows : -1;
+}
+
+bool LoadColumnsFile(ScmdpColumns *columns, char *path)
+{
+    ScmdpColumnsHeader *header;
+    size_t size = 0;
+
+    header = _MapFile(path, &size, false);
+    if (header == NULL)
+    {
+        return false;
+    }
+    if (size < sizeof(ScmdpColumnsHeader) || header->magic != SCMDP_COLUMNS_MAGIC || header->version != SCMDP_COLUMNS_VERSION ||
+        header->numOfRows > header->columnSize || header->headerSize > size ||
+        (size - header->headerSize) / (header->numOfOptArgs + 1ULL) < header->columnSize)
+    {
+        _UnmapFile(header, size);
+        return false;
+    }
+    columns->header = header;
+    columns->status = (signed char *)header + header->headerSize;
+    columns->mappedSize = size;
+    return true;
+}
+
+unsigned char *GetOptColumn(ScmdpColumns *columns, int optId)
+{
+    if (optId < 0 || (unsigned int)optId >= columns->header->numOfOptArgs)
+    {
+        return NULL;
+    }
+    return (unsigned char *)columns->status + (optId + 1) * columns->header->columnSize;
+}
+
+void DeleteColumns(ScmdpColumns *columns)
+{
+    if (columns->header != NULL)
+    {
+        _UnmapFile(columns->header, columns->mappedSize);
+    }
+    columns->header = NULL;
+    columns->status = NULL;
+    columns->mappedSize = 0;
+}
+
+ScmdpConsole AddConsole(int fd, char *prompt)
+{
+    ScmdpConsole newConsole;
+    newConsole.commands = malloc(sizeof(ScmdpCommand));
+    newConsole.numOfCommands = 0;
+    newConsole.fd = fd;
+    newConsole.prompt = prompt;
+    newConsole.line = malloc(SCMDP_LINE_SIZE);
+    newConsole.lineStart = 0;
+    newConsole.lineEnd = 0;
+    newConsole.isSkipping = false;
+    newConsole.numOfLongLines = 0;
+    newConsole.tokens = malloc(sizeof(char *) * (SCMDP_MAX_TOKENS + 1));
+    newConsole.readLine = NULL;
+    newConsole.readLineData = NULL;
+    return newConsole;
+}
+
+void AddConsoleCommand(ScmdpConsole *console, char *name, ScmdpWorkspace *workspace, ScmdpCommandHandler handler, void *userData)
+{
+    ScmdpCommand newCommand;
+    newCommand.name = name;
+    newCommand.workspace = workspace;
+    newCommand.context = AddParseContext(workspace);
+    newCommand.handler = handler;
+    newCommand.userData = userData;
+
+    console->numOfCommands += 1;
+    console->commands = realloc(console->commands, sizeof(ScmdpCommand) * console->numOfCommands);
+    console->commands[console->numOfCommands-1] = newCommand;
+}
+
+void SetConsoleReader(ScmdpConsole *console, ScmdpLineReader readLine, void *userData)
+{
+    console->readLine = readLine;
+    console->readLineData = userData;
+}
+
+bool ExecuteConsoleLine(ScmdpConsole *console, char *line)
+{
+    ScmdpCommand *command;
+    int numOfTokens;
+    int found;
+
+    numOfTokens = _SplitLine(line, console->tokens, SCMDP_MAX_TOKENS);
+    if (numOfTokens == 0)
+    {
+        return true;
+    }
+    if (numOfTokens < 0)
+    {
+        printf("Error: Too many words in command line!\n");
+        return true;
+    }
+
+    found = _FindConsoleCommand(console, console->tokens[0]);
+    if (found < 0)
+    {
+        printf("Error: Unknown command!\n");
+        return true;
+    }
+    command = &console->commands[found];
+
+    /* The name of command takes place of argv[0] */
+    if (!ParseArgsInContext(command->workspace, &command->context, numOfTokens, console->tokens))
+    {
+        _ShowParseFailure(command->workspace, &command->context);
+        printf("\n");
+        return true;
+    }
+    return command->handler(command->workspace, &command->context, command->userData);
+}
+
+void RunConsole(ScmdpConsole *console)
+{
+    char *line;
+    long long numOfLongLines = console->numOfLongLines;
+
+    while ((line = _ReadConsoleLine(console)) != NULL)
+    {
+        /* Skipped line is reported here, the server counts it without printing */
+        if (console->numOfLongLines != numOfLongLines)
+        {
+            numOfLongLines = console->numOfLongLines;
+            printf("Error: Too long command line!\n");
+        }
+        if (!ExecuteConsoleLine(console, line))
+        {
+            break;
+        }
+    }
+}
+
+void DeleteConsole(ScmdpConsole *console)
+{
+    for (int i = 0; i < console->numOfCommands; i++)
+    {
+        DeleteParseContext(&console->commands[i].context);
+    }
+    free(console->commands);
+    free(console->line);
+    free(console->tokens);
+    console->commands = NULL;
+    console->line = NULL;
+    console->tokens = NULL;
+    console->numOfCommands = 0;
+}
+
+void _ShowError(ScmdpWorkspace *workspace, ScmdpError *error)
+{
+    char *message;
+    char *optName = (error->optId >= 0) ? _OptArgName(workspace, error->optId) : "";
+    char *otherOptName = (error->otherOptId >= 0) ? _OptArgName(workspace, error->otherOptId) : "";
+
+    if (error->code == ERR_REPEATED_KEY && error->otherOptId == SCMDP_HELP_ID)
+    {
+        otherOptName = "help argument";
+    }
+    if (error->code == ERR_TOO_LONG_KEY && error->optId == SCMDP_HELP_ID)
+    {
+        optName = "help argument";
+    }
+    switch (error->code)
+    {
+    case ERR_NO_VAL_NOPT_PARAMETER:
+        message = "Error: Need a value for non-optional parameter!";
+        break;
+    case ERR_NO_VAL_OPT_PARAMETER:
+        message = "Error: Need a value for optional parameter!";
+        break;
+    case ERR_UNKNOWN_PARAMETER:
+        message = "Error: Unknown argument or option!";
+        break;
+    case ERR_WRONG_PARS_NUMBER:
+        message = "Error: Wrong number of parameters!";
+        break;
+    case ERR_WRONG_SYNTAX:
+        message = "Error: Wrong command line syntax!";
+        break;
+    case ERR_REQUIRED_OPTION:
+        message = "Error: Option %s requires option %s!";
+        break;
+    case ERR_CONFLICTING_OPTIONS:
+        message = "Error: Option %s conflicts with option %s!";
+        break;
+    case ERR_NO_OPTION_OF_GROUP:
+        message = "Error: Need at least one of options with %s!";
+        break;
+    case ERR_REJECTED_VALUE:
+        message = "Error: Value of option %s is rejected!";
+        break;
+    case ERR_WRONG_NUMBER:
+        message = "Error: Wrong number in value of option %s!";
+        break;
+    case ERR_OVER_BUDGET:
+        message = "Error: Command line exceeds the limits of parsing!";
+        break;
+    case ERR_NO_FILE:
+        message = "Error: File cannot be read!";
+        break;
+    case ERR_REPEATED_KEY:
+        message = "Error: Option %s repeats a key of %s!";
+        break;
+    case ERR_UNKNOWN_CONSTRAINT_KEY:
+        message = (error->optId >= 0) ? "Error: Constraint of option %s has an unknown key!" : "Error: Constraint has unknown keys!";
+        break;
+    case ERR_TOO_LONG_KEY:
+        /* Name of option may be the long key itself, only its beginning is printed */
+        message = "Error: Key of %.32s is too long!";
+        break;
+    default:
+        message = "Error: Something went wrong!";
+        break;
+    }
+    /* Messages about constraints take names of options, the others ignore them */
+    printf(message, optName, otherOptName);
+    for (int i = 0; i < error->numOfSuggestions; i++)
+    {
+        printf((i == 0) ? "\nDid you mean %s" : " or %s", error->suggestions[i]);
+    }
+    if (error->numOfSuggestions > 0)
+    {
+        printf("?");
+    }
+    printf("\nprint -h or --help to see help\n");
+}
+
+void _ShowHelp(ScmdpWorkspace *workspace, bool showFullHelp)
+{
+    /* Help text of loaded workspace is fixed up only now, normal startups never touch its pages */
+    LoadHelpText(workspace);
+    if(!showFullHelp)
+    {
+        printf("%s\n", workspace->syntaxHelp);
+    }
+    else
+    {
+        printf("%s\n\n%s\n", workspace->syntaxHelp, workspace->descriptHelp);
+        
+        printf("\n>> Non-optional arguments:\n");
+        for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+        {
+            printf("\n%3s%-10s", " ", workspace->nonOptArgs[i].key);
+            _PrintIndentedHelp(workspace->nonOptArgs[i].help, 13);
+        }
+        if (workspace->hasRestArg)
+        {
+            printf("\n%3s%s...%*s", " ", workspace->restArg.key, (int)(strlen(workspace->restArg.key) < 7 ? 7 - strlen(workspace->restArg.key) : 0), "");
+            _PrintIndentedHelp(workspace->restArg.help, 13);
+        }
+        printf("\n\n>> Optional agruments:\n");
+        for (int i = 0; i < workspace->numOfOptArgs; i++)
+        {
+            printf("\n%3s%-10s,%-5s%-7s", " ", workspace->optArgs[i].longKey, workspace->optArgs[i].shortKey, workspace->optArgs[i].valName);
+            _PrintIndentedHelp(workspace->optArgs[i].help, 26);
+        }
+    }
+}
+
+void _PrintIndentedHelp(char *help, int indent)
+{
+    char checkSymbol;
+
+    while ((checkSymbol = *help++))
+    {
+        if (checkSymbol == '\n')
+        {
+            printf("\n%*s", indent, "");
+        }
+        else
+        {
+            printf("%c", checkSymbol);
+        }
+    }
+}
+
+ScmdpServer AddServer(ScmdpConsole *console, int numOfWorkers, int queueSize)
+{
+    ScmdpServer newServer;
+    ScmdpServerWorker *workers;
+
+    newServer.console = console;
+    newServer.numOfWorkers = (numOfWorkers > 0) ? numOfWorkers : 1;
+    newServer.numOfSlots = 1;
+    while (newServer.numOfSlots < queueSize)
+    {
+        newServer.numOfSlots <<= 1;
+    }
+
+    /* Every worker parses with its own contexts, so nothing is shared but compiled workspaces */
+    newServer.contexts = malloc(sizeof(ScmdpParseContext) * (newServer.numOfWorkers * console->numOfCommands + 1));
+    newServer.tokens = malloc(sizeof(char *) * newServer.numOfWorkers * (SCMDP_MAX_TOKENS + 1));
+    workers = malloc(sizeof(ScmdpServerWorker) * newServer.numOfWorkers);
+    for (int i = 0; i < newServer.numOfWorkers; i++)
+    {
+        for (int j = 0; j < console->numOfCommands; j++)
+        {
+            newServer.contexts[i * console->numOfCommands + j] = AddParseContext(console->commands[j].workspace);
+        }
+        workers[i].id = i;
+    }
+    newServer.workers = workers;
+
+    newServer.slots = malloc(sizeof(ScmdpServerSlot) * newServer.numOfSlots);
+    for (long long i = 0; i < newServer.numOfSlots; i++)
+    {
+        newServer.slots[i].sequence = i;
+    }
+    newServer.head = 0;
+    newServer.tail = 0;
+    newServer.isClosed = 0;
+    newServer.isStopping = 0;
+    newServer.numOfLines = 0;
+    newServer.numOfHandled = 0;
+    newServer.numOfFailed = 0;
+    newServer.maxQueueDepth = 0;
+    newServer.startTime = 0;
+    newServer.stopTime = 0;
+    return newServer;
+}
+
+bool RunServer(ScmdpServer *server)
+{
+    ScmdpServerWorker *workers = server->workers;
+    ScmdpServerSlot *slot;
+    char *line;
+    long long position;
+    long long depth;
+    long long numOfLongLines;
+    int numOfStarted;
+    int numOfPolls;
+
+    server->head = 0;
+    server->tail = 0;
+    server->isClosed = 0;
+    server->isStopping = 0;
+    server->startTime = _GetTime();
+    server->stopTime = 0;
+    for (numOfStarted = 0; numOfStarted < server->numOfWorkers; numOfStarted++)
+    {
+        /* The server structure may be moved by copying before, so workers get its current address */
+        workers[numOfStarted].server = server;
+#ifdef _WIN32
+        workers[numOfStarted].thread = CreateThread(NULL, 0, _ServerThread, &workers[numOfStarted], 0, NULL);
+        if (workers[numOfStarted].thread == NULL)
+#else
+        if (pthread_create(&workers[numOfStarted].thread, NULL, _ServerThread, &workers[numOfStarted]) != 0)
+#endif
+        {
+            SCMDP_ATOMIC_STORE(&server->isStopping, 1);
+            break;
+        }
+    }
+
+    while (numOfStarted == server->numOfWorkers && SCMDP_ATOMIC_LOAD(&server->isStopping) == 0)
+    {
+        numOfLongLines = server->console->numOfLongLines;
+        line = _ReadConsoleLine(server->console);
+        if (server->console->numOfLongLines != numOfLongLines)
+        {
+            /* Skipped lines never reach the workers, so the reader counts them as failed */
+            SCMDP_ATOMIC_ADD(&server->numOfFailed, server->console->numOfLongLines - numOfLongLines);
+        }
+        if (line == NULL)
+        {
+            break;
+        }
+        if (*line == '\0')
+        {
+            continue;
+        }
+
+        /* The slot is free when workers have handled the line which was there a ring ago */
+        position = server->tail;
+        slot = &server->slots[position & (server->numOfSlots - 1)];
+        numOfPolls = 0;
+        while (SCMDP_ATOMIC_LOAD(&slot->sequence) != position)
+        {
+            _WaitServerQueue(numOfPolls++);
+        }
+        strcpy(slot->line, line);
+        SCMDP_ATOMIC_STORE(&slot->sequence, position + 1);
+        SCMDP_ATOMIC_STORE(&server->tail, position + 1);
+        SCMDP_ATOMIC_ADD(&server->numOfLines, 1);
+
+        depth = position + 1 - SCMDP_ATOMIC_LOAD(&server->head);
+        if (depth > server->maxQueueDepth)
+        {
+            SCMDP_ATOMIC_STORE(&server->maxQueueDepth, depth);
+        }
+    }
+
+    SCMDP_ATOMIC_STORE(&server->isClosed, 1);
+    for (int i = 0; i < numOfStarted; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(workers[i].thread, INFINITE);
+        CloseHandle(workers[i].thread);
+#else
+        pthread_join(workers[i].thread, NULL);
+#endif
+    }
+    SCMDP_ATOMIC_STORE(&server->stopTime, _GetTime());
+    return numOfStarted == server->numOfWorkers;
+}
+
+ScmdpServerMetrics GetServerMetrics(ScmdpServer *server)
+{
+    ScmdpServerMetrics metrics;
+    long long stopTime = SCMDP_ATOMIC_LOAD(&server->stopTime);
+
+    metrics.numOfLines = SCMDP_ATOMIC_LOAD(&server->numOfLines);
+    metrics.numOfHandled = SCMDP_ATOMIC_LOAD(&server->numOfHandled);
+    metrics.numOfFailed = SCMDP_ATOMIC_LOAD(&server->numOfFailed);
+    metrics.queueDepth = SCMDP_ATOMIC_LOAD(&server->tail) - SCMDP_ATOMIC_LOAD(&server->head);
+    metrics.maxQueueDepth = SCMDP_ATOMIC_LOAD(&server->maxQueueDepth);
+    if (metrics.queueDepth < 0)
+    {
+        metrics.queueDepth = 0;
+    }
+
+    /* While serving goes on, the time is counted till now */
+    metrics.seconds = (double)(((stopTime != 0) ? stopTime : _GetTime()) - server->startTime) / 1e9;
+    metrics.linesPerSecond = (metrics.seconds > 0) ? (double)(metrics.numOfHandled + metrics.numOfFailed) / metrics.seconds : 0;
+    return metrics;
+}
+
+void DeleteServer(ScmdpServer *server)
+{
+    for (int i = 0; i < server->numOfWorkers * server->console->numOfCommands; i++)
+    {
+        DeleteParseContext(&server->contexts[i]);
+    }
+    free(server->contexts);
+    free(server->tokens);
+    free(server->slots);
+    free(server->workers);
+    server->contexts = NULL;
+    server->tokens = NULL;
+    server->slots = NULL;
+    server->workers = NULL;
+    server->numOfWorkers = 0;
+}
+
+ScmdpConfigWatch AddConfigWatch(ScmdpWorkspace *workspace, ScmdpConfigHandler onChange, void *userData)
+{
+    ScmdpConfigWatch newWatch;
+
+    /* Context compiles the workspace, so the number of options is fixed from here */
+    newWatch.workspace = workspace;
+    newWatch.context = AddParseContext(workspace);
+    newWatch.files = NULL;
+    newWatch.numOfFiles = 0;
+    newWatch.current = calloc(1, sizeof(ScmdpConfigValues) + sizeof(char *) * (workspace->numOfOptArgs + 1));
+    newWatch.current->optVals = (char **)(newWatch.current + 1);
+    newWatch.current->numOfOptArgs = workspace->numOfOptArgs;
+    newWatch.epoch = 0;
+    newWatch.readers[0] = 0;
+    newWatch.readers[1] = 0;
+    newWatch.mergedVals = malloc(sizeof(char *) * (workspace->numOfOptArgs + 1));
+    newWatch.changedIds = malloc(sizeof(int) * (workspace->numOfOptArgs + 1));
+    newWatch.onChange = onChange;
+    newWatch.userData = userData;
+    newWatch.error = newWatch.context.error;
+#ifdef __linux__
+    newWatch.notifier = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+    newWatch.notifier = -1;
+#endif
+    return newWatch;
+}
+
+bool AddConfigFile(ScmdpConfigWatch *watch, char *path)
+{
+    ScmdpConfigFile *file;
+    size_t length = strlen(path);
+
+    watch->files = realloc(watch->files, sizeof(ScmdpConfigFile) * (watch->numOfFiles + 1));
+    file = &watch->files[watch->numOfFiles++];
+    file->path = malloc(length + 1);
+    memcpy(file->path, path, length + 1);
+    file->name = file->path;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (path[i] == '/' || path[i] == '\\')
+        {
+            file->name = file->path + i + 1;
+        }
+    }
+    file->text = NULL;
+    file->optVals = calloc(watch->current->numOfOptArgs + 1, sizeof(char *));
+    file->folderWatch = -1;
+    file->isChanged = false;
+    if (!_StatConfigFile(path, &file->modifyTime, &file->size))
+    {
+        file->modifyTime = -1;
+        file->size = -1;
+    }
+
+#ifdef __linux__
+    /* Editors often replace the file by renaming, so its folder is watched instead of the file itself */
+    if (watch->notifier >= 0)
+    {
+        char *folder = malloc(length + 2);
+
+        if (file->name == file->path)
+        {
+            strcpy(folder, ".");
+        }
+        else
+        {
+            memcpy(folder, path, file->name - file->path);
+            folder[file->name - file->path] = '\0';
+        }
+        file->folderWatch = inotify_add_watch(watch->notifier, folder, IN_CLOSE_WRITE | IN_MOVED_TO);
+        free(folder);
+    }
+#endif
+
+    /* The file is watched even if it's wrong now, so its correction is taken later */
+    if (!_ReadConfigFile(watch, file))
+    {
+        return false;
+    }
+    _PublishConfig(watch);
+    return true;
+}
+
+int PollConfigWatch(ScmdpConfigWatch *watch, int timeout)
+{
+    long long modifyTime, size;
+    bool isChanged = false;
+
+#ifdef __linux__
+    if (watch->notifier >= 0)
+    {
+        /* Buffer is aligned for events, every event is followed by the name of file */
+        union
+        {
+            struct inotify_event event;
+            char bytes[4096];
+        } buffer;
+        struct pollfd notifier = {watch->notifier, POLLIN, 0};
+        struct inotify_event *event;
+        ssize_t length;
+        int numOfReady = poll(&notifier, 1, timeout);
+
+        if (numOfReady < 0)
+        {
+            return (errno == EINTR) ? 0 : -1;
+        }
+        while (numOfReady > 0 && (length = read(watch->notifier, buffer.bytes, sizeof(buffer.bytes))) > 0)
+        {
+            for (char *cursor = buffer.bytes; cursor < buffer.bytes + length; cursor += sizeof(struct inotify_event) + event->len)
+            {
+                event = (struct inotify_event *)cursor;
+                for (int i = 0; event->len > 0 && i < watch->numOfFiles; i++)
+                {
+                    if (watch->files[i].folderWatch == event->wd && strcmp(watch->files[i].name, event->name) == 0)
+                    {
+                        watch->files[i].isChanged = true;
+                        isChanged = true;
+                    }
+                }
+            }
+        }
+    }
+    else
+#endif
+    {
+        /* Without notifications the files are compared with their state at the last reading */
+#ifdef _WIN32
+        Sleep(timeout);
+#else
+        struct timespec pause = {timeout / 1000, (timeout % 1000) * 1000000L};
+
+        nanosleep(&pause, NULL);
+#endif
+        for (int i = 0; i < watch->numOfFiles; i++)
+        {
+            if (_StatConfigFile(watch->files[i].path, &modifyTime, &size)
+                && (modifyTime != watch->files[i].modifyTime || size != watch->files[i].size))
+            {
+                watch->files[i].isChanged = true;
+                isChanged = true;
+            }
+        }
+    }
+    if (!isChanged)
+    {
+        return 0;
+    }
+
+    /* Only the changed files are parsed again, the others keep their values */
+    for (int i = 0; i < watch->numOfFiles; i++)
+    {
+        if (watch->files[i].isChanged)
+        {
+            watch->files[i].isChanged = false;
+            _StatConfigFile(watch->files[i].path, &watch->files[i].modifyTime, &watch->files[i].size);
+            _ReadConfigFile(watch, &watch->files[i]);
+        }
+    }
+    return _PublishConfig(watch);
+}
+
+int EnterConfig(ScmdpConfigWatch *watch, ScmdpConfigValues **values)
+{
+    long long epoch;
+
+    /**
+    *   Reader counts itself in the counter of current epoch. If the epoch is flipped meanwhile,
+    *   the writer may have checked this counter already, so the reader tries again.
+    *   Read-modify-write orders the check after the increment, plain load doesn't
+    */
+    while (true)
+    {
+        epoch = SCMDP_ATOMIC_LOAD(&watch->epoch);
+        SCMDP_ATOMIC_ADD(&watch->readers[epoch & 1], 1);
+        if (SCMDP_ATOMIC_ADD(&watch->epoch, 0) == epoch)
+        {
+            break;
+        }
+        SCMDP_ATOMIC_ADD(&watch->readers[epoch & 1], -1);
+    }
+    *values = SCMDP_ATOMIC_LOAD_POINTER(&watch->current);
+    return (int)(epoch & 1);
+}
+
+void LeaveConfig(ScmdpConfigWatch *watch, int ticket)
+{
+    SCMDP_ATOMIC_ADD(&watch->readers[ticket], -1);
+}
+
+void DeleteConfigWatch(ScmdpConfigWatch *watch)
+{
+    for (int i = 0; i < watch->numOfFiles; i++)
+    {
+        free(watch->files[i].path);
+        free(watch->files[i].text);
+        free(watch->files[i].optVals);
+    }
+#ifdef __linux__
+    if (watch->notifier >= 0)
+    {
+        close(watch->notifier);
+    }
+#endif
+    DeleteParseContext(&watch->context);
+    free(watch->files);
+    free(watch->current);
+    free(watch->mergedVals);
+    free(watch->changedIds);
+    watch->files = NULL;
+    watch->current = NULL;
+    watch->mergedVals = NULL;
+    watch->changedIds = NULL;
+    watch->numOfFiles = 0;
+    watch->notifier = -1;
+}
+
+bool _ReadConfigFile(ScmdpConfigWatch *watch, ScmdpConfigFile *file)
+{
+    ScmdpWorkspace *workspace = watch->workspace;
+    ScmdpParseContext *context = &watch->context;
+    FILE *stream = fopen(file->path, "rb");
+    char *text = NULL;
+    char **tokens;
+    long size = -1;
+    int numOfTokens;
+    bool isLineStart = true;
+
+    if (stream != NULL && fseek(stream, 0, SEEK_END) == 0)
+    {
+        size = ftell(stream);
+    }
+    if (size >= 0)
+    {
+        text = malloc(size + 1);
+    }
+    if (text == NULL || fseek(stream, 0, SEEK_SET) != 0 || fread(text, 1, size, stream) != (size_t)size)
+    {
+        if (stream != NULL)
+        {
+            fclose(stream);
+        }
+        free(text);
+        watch->error.code = ERR_NO_FILE;
+        watch->error.argIndex = 0;
+        watch->error.optId = -1;
+        watch->error.otherOptId = -1;
+        watch->error.numOfSuggestions = 0;
+        return false;
+    }
+    fclose(stream);
+    text[size] = '\0';
+
+    /* Comments are blanked and lines are joined, so the file is split as one command line */
+    for (long i = 0; i < size; i++)
+    {
+        if (text[i] == '\n')
+        {
+            text[i] = ' ';
+            isLineStart = true;
+        }
+        else if (isLineStart && text[i] == '#')
+        {
+            while (i < size && text[i] != '\n')
+            {
+                text[i++] = ' ';
+            }
+            i--;
+        }
+        else if (text[i] != ' ' && text[i] != '\t' && text[i] != '\r')
+        {
+            isLineStart = false;
+        }
+    }
+
+    /* Every word takes two characters at least, path of file stands for argv[0] */
+    tokens = malloc(sizeof(char *) * (size / 2 + 3));
+    tokens[0] = file->path;
+    numOfTokens = _SplitLine(text, tokens + 1, size / 2 + 1) + 1;
+
+    _ResetParseContext(workspace, context);
+    if (!_CheckCompileError(workspace, context))
+    {
+        /* No option is read from the file, the error is kept as the error of watch */
+        numOfTokens = 1;
+    }
+    _ClassifyTokens(workspace, context, numOfTokens, tokens);
+    for (int i = 1; i < numOfTokens; i++)
+    {
+        if (!SCMDP_IS_OPTION(context, i))
+        {
+            _SetParseError(context, ERR_WRONG_SYNTAX, i);
+            break;
+        }
+        i = _ParseOptArg(workspace, context, tokens, i, numOfTokens);
+        if (i == 0)
+        {
+            break;
+        }
+    }
+    free(tokens);
+    watch->error = context->error;
+    if (context->error.code != ERR_NONE)
+    {
+        free(text);
+        return false;
+    }
+
+    /* Values point into the text of file, the previous text is not needed anymore */
+    memcpy(file->optVals, context->optVals, sizeof(char *) * context->numOfOptArgs);
+    free(file->text);
+    file->text = text;
+    return true;
+}
+
+int _PublishConfig(ScmdpConfigWatch *watch)
+{
+    ScmdpConfigValues *oldValues = watch->current;
+    ScmdpConfigValues *newValues;
+    int numOfOptArgs = oldValues->numOfOptArgs;
+    int numOfChanged = 0;
+    size_t poolSize = 0, length;
+    char *pool;
+    long long epoch;
+
+    /* Later files override the earlier ones, values are compared with the published ones by option id */
+    for (int i = 0; i < numOfOptArgs; i++)
+    {
+        watch->mergedVals[i] = NULL;
+        for (int j = watch->numOfFiles - 1; j >= 0 && watch->mergedVals[i] == NULL; j--)
+        {
+            watch->mergedVals[i] = watch->files[j].optVals[i];
+        }
+        if (watch->mergedVals[i] == NULL)
+        {
+            if (oldValues->optVals[i] != NULL)
+            {
+                watch->changedIds[numOfChanged++] = i;
+            }
+            continue;
+        }
+        if (oldValues->optVals[i] == NULL || strcmp(watch->mergedVals[i], oldValues->optVals[i]) != 0)
+        {
+            watch->changedIds[numOfChanged++] = i;
+        }
+        poolSize += strlen(watch->mergedVals[i]) + 1;
+    }
+    if (numOfChanged == 0)
+    {
+        return 0;
+    }
+
+    /* Snapshot doesn't depend on texts of files, so they are free to be read again */
+    newValues = malloc(sizeof(ScmdpConfigValues) + sizeof(char *) * (numOfOptArgs + 1) + poolSize);
+    newValues->optVals = (char **)(newValues + 1);
+    newValues->numOfOptArgs = numOfOptArgs;
+    pool = (char *)(newValues->optVals + numOfOptArgs + 1);
+    for (int i = 0; i < numOfOptArgs; i++)
+    {
+        newValues->optVals[i] = NULL;
+        if (watch->mergedVals[i] != NULL)
+        {
+            length = strlen(watch->mergedVals[i]) + 1;
+            newValues->optVals[i] = memcpy(pool, watch->mergedVals[i], length);
+            pool += length;
+        }
+    }
+
+    /**
+    *   New readers take the new values and count themselves in the other counter,
+    *   so the old values are freed as soon as the readers of previous epoch leave
+    */
+    SCMDP_ATOMIC_STORE_POINTER(&watch->current, newValues);
+    epoch = SCMDP_ATOMIC_ADD(&watch->epoch, 1);
+    for (int numOfPolls = 0; SCMDP_ATOMIC_LOAD(&watch->readers[epoch & 1]) != 0; numOfPolls++)
+    {
+        _WaitServerQueue(numOfPolls);
+    }
+    free(oldValues);
+
+    if (watch->onChange != NULL)
+    {
+        watch->onChange(newValues, watch->changedIds, numOfChanged, watch->userData);
+    }
+    return numOfChanged;
+}
+
+bool _StatConfigFile(char *path, long long *modifyTime, long long *size)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+    {
+        return false;
+    }
+    *modifyTime = ((long long)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+    *size = ((long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+#else
+    struct stat fileStat;
+
+    if (stat(path, &fileStat) != 0)
+    {
+        return false;
+    }
+    *modifyTime = (long long)fileStat.st_mtim.tv_sec * 1000000000LL + fileStat.st_mtim.tv_nsec;
+    *size = (long long)fileStat.st_size;
+#endif
+    return true;
+}
+
+bool _ExpandRestGlobs(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    ScmdpGlob *glob = workspace->glob;
+    char **paths;
+    int first;
+    int numOfMatches;
+    bool isStopped = false;
+
+    context->pathPoolUsed = 0;
+    context->numOfPaths = 0;
+    for (int i = 0; i < context->numOfRestVals && !isStopped; i++)
+    {
+        first = context->numOfPaths;
+        if (strpbrk(context->restVals[i], "*?[") != NULL)
+        {
+            numOfMatches = _ScanGlob(glob, context, context->restVals[i]);
+            isStopped = (numOfMatches < 0);
+            if (numOfMatches != 0)
+            {
+                /* Threads add the matches in any order, so they are sorted like the shell does */
+                if (context->numOfPaths - first > 1)
+                {
+                    paths = malloc(sizeof(char *) * (context->numOfPaths - first));
+                    for (int k = first; k < context->numOfPaths; k++)
+                    {
+                        paths[k - first] = context->pathPool + context->pathOffsets[k];
+                    }
+                    qsort(paths, context->numOfPaths - first, sizeof(char *), _ComparePaths);
+                    for (int k = first; k < context->numOfPaths; k++)
+                    {
+                        context->pathOffsets[k] = paths[k - first] - context->pathPool;
+                    }
+                    free(paths);
+                }
+                continue;
+            }
+        }
+
+        /* Literal values and patterns matching nothing are kept as they are */
+        if (glob->onMatch != NULL)
+        {
+            isStopped = !glob->onMatch(context->restVals[i], glob->userData);
+        }
+        else
+        {
+            _AddPoolPath(context, context->restVals[i]);
+        }
+    }
+
+    if (glob->onMatch != NULL)
+    {
+        context->numOfRestVals = 0;
+        return true;
+    }
+
+    /* Pointers are made at the end, the pool may be moved while it grows */
+    context->globVals = realloc(context->globVals, sizeof(char *) * (context->pathsSize + 1));
+    for (int k = 0; k < context->numOfPaths; k++)
+    {
+        context->globVals[k] = context->pathPool + context->pathOffsets[k];
+    }
+    context->restVals = context->globVals;
+    context->numOfRestVals = context->numOfPaths;
+    if (workspace->restArg.maxCount >= 0 && context->numOfRestVals > workspace->restArg.maxCount)
+    {
+        return _SetParseError(context, ERR_WRONG_PARS_NUMBER, workspace->numOfNonOptArgs + context->numOfRestVals);
+    }
+    return true;
+}
+
+int _ScanGlob(ScmdpGlob *glob, ScmdpParseContext *context, char *pattern)
+{
+    ScmdpGlobScan scan;
+    ScmdpGlobFolder root;
+    char *copy;
+    int numOfStarted;
+#ifdef _WIN32
+    HANDLE *threads = malloc(sizeof(HANDLE) * glob->numOfThreads);
+#else
+    pthread_t *threads = malloc(sizeof(pthread_t) * glob->numOfThreads);
+#endif
+
+    scan.glob = glob;
+    scan.context = context;
+    scan.patternLength = strlen(pattern);
+    scan.segments = malloc(sizeof(char *) * (scan.patternLength / 2 + 2));
+    scan.numOfSegments = 0;
+    scan.folders = NULL;
+    scan.numOfFolders = 0;
+    scan.foldersSize = 0;
+    scan.numOfBusy = 0;
+    scan.lock = 0;
+    scan.numOfMatches = 0;
+    scan.isStopped = false;
+
+    /* Pattern is split into segments in its copy, empty ones of repeated '/' are skipped */
+    copy = malloc(scan.patternLength + 1);
+    memcpy(copy, pattern, scan.patternLength + 1);
+    /* Split by hand, strtok() is not reentrant and the server runs parsers in many workers */
+    for (char *cursor = copy; *cursor != '\0'; cursor++)
+    {
+        if (*cursor == '/')
+        {
+            *cursor = '\0';
+        }
+        else if (cursor == copy || cursor[-1] == '\0')
+        {
+            scan.segments[scan.numOfSegments++] = cursor;
+        }
+    }
+    root.path = (*pattern == '/') ? "/" : "";
+    root.segment = 0;
+    if (scan.numOfSegments > 0)
+    {
+        _PushGlobFolder(&scan, root.path, strlen(root.path), 0);
+    }
+
+    /* The calling thread scans too, so one thread means no thread is started */
+    for (numOfStarted = 0; numOfStarted < glob->numOfThreads - 1; numOfStarted++)
+    {
+#ifdef _WIN32
+        threads[numOfStarted] = CreateThread(NULL, 0, _GlobThread, &scan, 0, NULL);
+        if (threads[numOfStarted] == NULL)
+#else
+        if (pthread_create(&threads[numOfStarted], NULL, _GlobThread, &scan) != 0)
+#endif
+        {
+            break;
+        }
+    }
+    _RunGlobWorker(&scan);
+    for (int i = 0; i < numOfStarted; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    /* Directories are left in the stack only if the handler asked to stop */
+    for (int i = 0; i < scan.numOfFolders; i++)
+    {
+        free(scan.folders[i].path);
+    }
+    free(scan.folders);
+    free(scan.segments);
+    free(copy);
+    free(threads);
+    return scan.isStopped ? -1 : scan.numOfMatches;
+}
+
+#ifdef _WIN32
+DWORD WINAPI _GlobThread(LPVOID scan)
+{
+    _RunGlobWorker(scan);
+    return 0;
+}
+#else
+void *_GlobThread(void *scan)
+{
+    _RunGlobWorker(scan);
+    return NULL;
+}
+#endif
+
+void _RunGlobWorker(ScmdpGlobScan *scan)
+{
+    ScmdpGlobFolder folder;
+    bool isDone;
+    int numOfPolls = 0;
+
+    while (true)
+    {
+        _LockGlobScan(scan);
+        if (scan->numOfFolders > 0 && !scan->isStopped)
+        {
+            folder = scan->folders[--scan->numOfFolders];
+            scan->numOfBusy++;
+            SCMDP_ATOMIC_STORE(&scan->lock, 0);
+
+            _ScanGlobFolder(scan, &folder);
+            free(folder.path);
+
+            _LockGlobScan(scan);
+            scan->numOfBusy--;
+            SCMDP_ATOMIC_STORE(&scan->lock, 0);
+            numOfPolls = 0;
+            continue;
+        }
+
+        /* The stack is empty for good when no thread scans a directory which may push more */
+        isDone = scan->isStopped || scan->numOfBusy == 0;
+        SCMDP_ATOMIC_STORE(&scan->lock, 0);
+        if (isDone)
+        {
+            break;
+        }
+        _WaitServerQueue(numOfPolls++);
+    }
+}
+
+void _ScanGlobFolder(ScmdpGlobScan *scan, ScmdpGlobFolder *folder)
+{
+    size_t length = strlen(folder->path);
+    size_t segmentLength;
+    int segment = folder->segment;
+    int last = scan->numOfSegments - 1;
+    char *path = malloc(length + scan->patternLength + SCMDP_GLOB_NAME_SIZE + 2);
+    char *pattern;
+    bool isRecursive;
+
+    memcpy(path, folder->path, length);
+    while (strpbrk(scan->segments[segment], "*?[") == NULL)
+    {
+        segmentLength = strlen(scan->segments[segment]);
+        memcpy(path + length, scan->segments[segment], segmentLength);
+        length += segmentLength;
+        if (segment == last)
+        {
+            /* Pattern ends with literal names, they are matched if the path exists */
+            path[length] = '\0';
+#ifdef _WIN32
+            if (GetFileAttributesA(path) != INVALID_FILE_ATTRIBUTES)
+#else
+            if (access(path, F_OK) == 0)
+#endif
+            {
+                _AddGlobPath(scan, path);
+            }
+            free(path);
+            return;
+        }
+        path[length++] = '/';
+        segment++;
+    }
+    path[length] = '\0';
+    pattern = scan->segments[segment];
+    isRecursive = (strcmp(pattern, "**") == 0);
+    if (isRecursive && segment < last)
+    {
+        /* '**' matches no directory too */
+        _PushGlobFolder(scan, path, length, segment + 1);
+    }
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE finder;
+
+    memcpy(path + length, "*", 2);
+    finder = FindFirstFileA(path, &entry);
+    if (finder != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if ((entry.cFileName[0] == '.' && pattern[0] != '.') || (!isRecursive && !_MatchGlob(pattern, entry.cFileName)))
+            {
+                continue;
+            }
+            /* Links to directories are not followed by '**', they may make a loop */
+            if (!_AddGlobEntry(scan, path, length, segment, entry.cFileName,
+                               (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 &&
+                               !(isRecursive && (entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)))
+            {
+                break;
+            }
+        } while (FindNextFileA(finder, &entry));
+        FindClose(finder);
+    }
+#else
+    /* Directory is opened by descriptor and read by readdir(), it takes entries from the kernel in large batches */
+    int folderFd = openat(AT_FDCWD, (length > 0) ? path : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR *folderStream = (folderFd >= 0) ? fdopendir(folderFd) : NULL;
+    struct dirent *entry;
+    int isFolder;
+
+    if (folderStream == NULL && folderFd >= 0)
+    {
+        close(folderFd);
+    }
+    while (folderStream != NULL && (entry = readdir(folderStream)) != NULL)
+    {
+        /* Names beginning with '.' (also '.' and '..') are matched only by a segment beginning with '.' */
+        if ((entry->d_name[0] == '.' && pattern[0] != '.') || (!isRecursive && !_MatchGlob(pattern, entry->d_name)))
+        {
+            continue;
+        }
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+        isFolder = -1;
+#ifdef DT_DIR
+        if (entry->d_type == DT_DIR || entry->d_type == DT_REG || (isRecursive && entry->d_type == DT_LNK))
+        {
+            /* Links to directories are not followed by '**', they may make a loop */
+            isFolder = (entry->d_type == DT_DIR);
+        }
+#endif
+        if (!_AddGlobEntry(scan, path, length, segment, entry->d_name, isFolder))
+        {
+            break;
+        }
+    }
+    if (folderStream != NULL)
+    {
+        closedir(folderStream);
+    }
+#endif
+    free(path);
+}
+
+bool _AddGlobEntry(ScmdpGlobScan *scan, char *path, size_t length, int segment, char *name, int isFolder)
+{
+    size_t nameLength = strlen(name);
+    bool isRecursive = (strcmp(scan->segments[segment], "**") == 0);
+
+    memcpy(path + length, name, nameLength + 1);
+    if (segment == scan->numOfSegments - 1 && !_AddGlobPath(scan, path))
+    {
+        return false;
+    }
+    if (segment == scan->numOfSegments - 1 && !isRecursive)
+    {
+        return true;
+    }
+
+#ifndef _WIN32
+    struct stat entryStat;
+
+    if (isFolder < 0)
+    {
+        isFolder = ((isRecursive ? lstat(path, &entryStat) : stat(path, &entryStat)) == 0 && S_ISDIR(entryStat.st_mode));
+    }
+#endif
+    if (isFolder)
+    {
+        path[length + nameLength] = '/';
+        _PushGlobFolder(scan, path, length + nameLength + 1, isRecursive ? segment : segment + 1);
+    }
+    return true;
+}
+
+void _PushGlobFolder(ScmdpGlobScan *scan, char *path, size_t length, int segment)
+{
+    char *newPath = malloc(length + 1);
+
+    memcpy(newPath, path, length);
+    newPath[length] = '\0';
+
+    _LockGlobScan(scan);
+    if (scan->numOfFolders == scan->foldersSize)
+    {
+        scan->foldersSize = scan->foldersSize * 2 + 16;
+        scan->folders = realloc(scan->folders, sizeof(ScmdpGlobFolder) * scan->foldersSize);
+    }
+    scan->folders[scan->numOfFolders].path = newPath;
+    scan->folders[scan->numOfFolders].segment = segment;
+    scan->numOfFolders++;
+    SCMDP_ATOMIC_STORE(&scan->lock, 0);
+}
+
+bool _AddGlobPath(ScmdpGlobScan *scan, char *path)
+{
+    bool isStopped;
+
+    _LockGlobScan(scan);
+    if (!scan->isStopped && scan->glob->onMatch != NULL)
+    {
+        /* Handler is called under the lock, so it never runs in two threads at once */
+        scan->isStopped = !scan->glob->onMatch(path, scan->glob->userData);
+    }
+    else if (!scan->isStopped)
+    {
+        _AddPoolPath(scan->context, path);
+    }
+    scan->numOfMatches++;
+    isStopped = scan->isStopped;
+    SCMDP_ATOMIC_STORE(&scan->lock, 0);
+    return !isStopped;
+}
+
+void _AddPoolPath(ScmdpParseContext *context, char *path)
+{
+    size_t length = strlen(path) + 1;
+
+    if (context->numOfPaths == context->pathsSize)
+    {
+        context->pathsSize = context->pathsSize * 2 + 16;
+        context->pathOffsets = realloc(context->pathOffsets, sizeof(size_t) * context->pathsSize);
+    }
+    if (context->pathPoolUsed + length > context->pathPoolSize)
+    {
+        context->pathPoolSize = (context->pathPoolSize + length) * 2;
+        context->pathPool = realloc(context->pathPool, context->pathPoolSize);
+    }
+    memcpy(context->pathPool + context->pathPoolUsed, path, length);
+    context->pathOffsets[context->numOfPaths++] = context->pathPoolUsed;
+    context->pathPoolUsed += length;
+}
+
+void _LockGlobScan(ScmdpGlobScan *scan)
+{
+    int numOfPolls = 0;
+
+    while (!SCMDP_ATOMIC_CAS(&scan->lock, 0, 1))
+    {
+        _WaitServerQueue(numOfPolls++);
+    }
+}
+
+bool _MatchGlob(const char *pattern, const char *name)
+{
+    const char *starPattern = NULL;
+    const char *starName = NULL;
+    int classLength;
+
+    while (*name != '\0')
+    {
+        if (*pattern == '*')
+        {
+            /* The star is remembered, it takes one more character on every mismatch after it */
+            starPattern = ++pattern;
+            starName = name;
+            continue;
+        }
+        classLength = (*pattern == '[') ? _MatchGlobClass(pattern, *name) : -1;
+        if (classLength > 0)
+        {
+            pattern += classLength;
+            name++;
+            continue;
+        }
+        if (classLength < 0 && *pattern != '\0' && (*pattern == '?' || *pattern == *name))
+        {
+            pattern++;
+            name++;
+            continue;
+        }
+        if (starPattern == NULL)
+        {
+            return false;
+        }
+        pattern = starPattern;
+        name = ++starName;
+    }
+    while (*pattern == '*')
+    {
+        pattern++;
+    }
+    return *pattern == '\0';
+}
+
+int _MatchGlobClass(const char *pattern, char c)
+{
+    const char *p = pattern + 1;
+    bool isNegated = (*p == '!' || *p == '^');
+    bool isMatched = false;
+
+    if (isNegated)
+    {
+        p++;
+    }
+    /* ']' right after '[' is a member of class */
+    do
+    {
+        if (*p == '\0')
+        {
+            return -1;
+        }
+        if (p[1] == '-' && p[2] != ']' && p[2] != '\0')
+        {
+            isMatched = isMatched || ((unsigned char)c >= (unsigned char)p[0] && (unsigned char)c <= (unsigned char)p[2]);
+            p += 3;
+        }
+        else
+        {
+            isMatched = isMatched || (c == *p);
+            p++;
+        }
+    } while (*p != ']');
+    return (isMatched != isNegated) ? (int)(p - pattern + 1) : 0;
+}
+
+int _ComparePaths(const void *left, const void *right)
+{
+    return strcmp(*(char *const *)left, *(char *const *)right);
+}
+
+void _RunLogShards(ScmdpLogShard *shards, int numOfShards)
+{
+    bool *isStarted = calloc(numOfShards, sizeof(bool));
+
+    for (int i = 1; i < numOfShards; i++)
+    {
+#ifdef _WIN32
+        shards[i].thread = CreateThread(NULL, 0, _LogThread, &shards[i], 0, NULL);
+        isStarted[i] = (shards[i].thread != NULL);
+#else
+        isStarted[i] = (pthread_create(&shards[i].thread, NULL, _LogThread, &shards[i]) == 0);
+#endif
+    }
+    for (int i = 0; i < numOfShards; i++)
+    {
+        if (!isStarted[i])
+        {
+            _RunLogShard(&shards[i]);
+        }
+    }
+    for (int i = 1; i < numOfShards; i++)
+    {
+        if (!isStarted[i])
+        {
+            continue;
+        }
+#ifdef _WIN32
+        WaitForSingleObject(shards[i].thread, INFINITE);
+        CloseHandle(shards[i].thread);
+#else
+        pthread_join(shards[i].thread, NULL);
+#endif
+    }
+    free(isStarted);
+}
+
+#ifdef _WIN32
+DWORD WINAPI _LogThread(LPVOID shard)
+{
+    _RunLogShard(shard);
+    return 0;
+}
+#else
+void *_LogThread(void *shard)
+{
+    _RunLogShard(shard);
+    return NULL;
+}
+#endif
+
+void _RunLogShard(ScmdpLogShard *shard)
+{
+    ScmdpWorkspace *workspace = shard->workspace;
+    ScmdpParseContext *context = &shard->context;
+    unsigned long long row = shard->firstRow;
+    unsigned long long word;
+    unsigned char *counts;
+    char *tokens[SCMDP_MAX_TOKENS + 1];
+    char *buffer = NULL;
+    size_t bufferSize = 0;
+    size_t length;
+    char *line;
+    char *next;
+    int numOfTokens;
+    int optId;
+    bool success;
+
+    if (shard->status == NULL)
+    {
+        shard->numOfRows = 0;
+        for (line = shard->begin; line < shard->end; line = next + 1)
+        {
+            next = memchr(line, '\n', shard->end - line);
+            if (next == NULL)
+            {
+                /* The last line of log may have no line end */
+                next = shard->end;
+            }
+            shard->numOfRows++;
+        }
+        return;
+    }
+
+    for (line = shard->begin; line < shard->end; line = next + 1, row++)
+    {
+        next = memchr(line, '\n', shard->end - line);
+        if (next == NULL)
+        {
+            next = shard->end;
+        }
+
+        /* Mapped log is read-only, the line is split in the buffer of thread */
+        length = next - line;
+        if (length + 1 > bufferSize)
+        {
+            bufferSize = (length + 1) * 2;
+            buffer = realloc(buffer, bufferSize);
+        }
+        memcpy(buffer, line, length);
+        buffer[length] = '\0';
+
+        numOfTokens = _SplitLine(buffer, tokens, SCMDP_MAX_TOKENS);
+        if (numOfTokens == 0)
+        {
+            shard->status[row] = SCMDP_STATUS_EMPTY;
+            continue;
+        }
+        if (numOfTokens < 0)
+        {
+            shard->status[row] = ERR_OVER_BUDGET;
+            continue;
+        }
+        success = _ParseCore(workspace, context, numOfTokens, tokens) &&
+                  (workspace->optTypes == NULL || _ConvertOptVals(workspace, context, false));
+        if (context->isHelpCalled)
+        {
+            shard->status[row] = SCMDP_STATUS_HELP;
+        }
+        else
+        {
+            shard->status[row] = (signed char)context->error.code;
+        }
+        if (!success)
+        {
+            continue;
+        }
+
+        /* The file is made with zeros, only entered options are written */
+        for (int w = 0; w <= workspace->numOfOptArgs / 64; w++)
+        {
+            optId = w * 64;
+            for (word = context->presentBits[w]; word != 0; word >>= 1, optId++)
+            {
+                if (word & 1)
+                {
+                    counts = (unsigned char *)shard->status + (optId + 1) * shard->columnSize;
+                    counts[row] = context->optCounts[optId];
+                }
+            }
+        }
+    }
+    free(buffer);
+}
+
+void *_MapFile(char *path, size_t *size, bool isWritable)
+{
+    void *data = NULL;
+#ifdef _WIN32
+    HANDLE file, mapping;
+    LARGE_INTEGER fileSize;
+
+    if (isWritable)
+    {
+        file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    }
+    else
+    {
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    }
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+    if (!isWritable && GetFileSizeEx(file, &fileSize))
+    {
+        *size = (size_t)fileSize.QuadPart;
+    }
+    if (*size > 0)
+    {
+        /* Mapping extends the new file with zeros up to its size */
+        mapping = CreateFileMappingA(file, NULL, isWritable ? PAGE_READWRITE : PAGE_READONLY,
+                                     (DWORD)((unsigned long long)*size >> 32), (DWORD)*size, NULL);
+        if (mapping != NULL)
+        {
+            data = MapViewOfFile(mapping, isWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    struct stat fileStat;
+    int file;
+
+    file = isWritable ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return NULL;
+    }
+    if (!isWritable && fstat(file, &fileStat) == 0)
+    {
+        *size = (size_t)fileStat.st_size;
+    }
+    if (*size > 0 && (!isWritable || ftruncate(file, (off_t)*size) == 0))
+    {
+        data = mmap(NULL, *size, isWritable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+        if (data == MAP_FAILED)
+        {
+            data = NULL;
+        }
+        else if (!isWritable)
+        {
+            /* The file is read once from the beginning to the end, so the kernel may read ahead a lot */
+            posix_madvise(data, *size, POSIX_MADV_SEQUENTIAL);
+        }
+    }
+    close(file);
+#endif
+    return data;
+}
+
+void _UnmapFile(void *data, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+int _FindConsoleCommand(ScmdpConsole *console, char *name)
+{
+    for (int i = 0; i < console->numOfCommands; i++)
+    {
+        if (strcmp(name, console->commands[i].name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#ifdef _WIN32
+DWORD WINAPI _ServerThread(LPVOID worker)
+{
+    _RunServerWorker(worker);
+    return 0;
+}
+#else
+void *_ServerThread(void *worker)
+{
+    _RunServerWorker(worker);
+    return NULL;
+}
+#endif
+
+void _RunServerWorker(ScmdpServerWorker *worker)
+{
+    ScmdpServer *server = worker->server;
+    ScmdpServerSlot *slot;
+    long long position;
+    long long isClosed;
+    int numOfPolls = 0;
+
+    while (true)
+    {
+        /* Closing is checked before polling, so the lines queued before closing are never lost */
+        isClosed = SCMDP_ATOMIC_LOAD(&server->isClosed);
+        position = SCMDP_ATOMIC_LOAD(&server->head);
+        slot = &server->slots[position & (server->numOfSlots - 1)];
+
+        if (SCMDP_ATOMIC_LOAD(&slot->sequence) == position + 1)
+        {
+            /* Workers race for the line, only one of them moves the head */
+            if (SCMDP_ATOMIC_CAS(&server->head, position, position + 1))
+            {
+                _ServeLine(worker, slot->line);
+                SCMDP_ATOMIC_STORE(&slot->sequence, position + server->numOfSlots);
+                numOfPolls = 0;
+            }
+        }
+        else if (isClosed)
+        {
+            break;
+        }
+        else
+        {
+            _WaitServerQueue(numOfPolls++);
+        }
+    }
+}
+
+void _ServeLine(ScmdpServerWorker *worker, char *line)
+{
+    ScmdpServer *server = worker->server;
+    ScmdpConsole *console = server->console;
+    ScmdpCommand *command;
+    ScmdpParseContext *context;
+    char **tokens = server->tokens + worker->id * (SCMDP_MAX_TOKENS + 1);
+    int numOfTokens;
+    int found = -1;
+
+    numOfTokens = _SplitLine(line, tokens, SCMDP_MAX_TOKENS);
+    if (numOfTokens > 0)
+    {
+        found = _FindConsoleCommand(console, tokens[0]);
+    }
+    if (found < 0)
+    {
+        SCMDP_ATOMIC_ADD(&server->numOfFailed, 1);
+        return;
+    }
+
+    /* Values are not scattered to valPlace, they would be shared by all workers */
+    command = &console->commands[found];
+    context = &server->contexts[worker->id * console->numOfCommands + found];
+    if (_ParseValues(command->workspace, context, numOfTokens, tokens) &&
+        command->handler(command->workspace, context, command->userData))
+    {
+        SCMDP_ATOMIC_ADD(&server->numOfHandled, 1);
+        return;
+    }
+    if (!context->isHelpCalled && context->error.code == ERR_NONE)
+    {
+        /* The handler asked to stop */
+        SCMDP_ATOMIC_STORE(&server->isStopping, 1);
+    }
+    SCMDP_ATOMIC_ADD(&server->numOfFailed, 1);
+}
+
+void _WaitServerQueue(int numOfPolls)
+{
+#ifdef _WIN32
+    if (numOfPolls < SCMDP_SPIN_LIMIT)
+    {
+        SwitchToThread();
+    }
+    else
+    {
+        Sleep(1);
+    }
+#else
+    struct timespec pause = {0, 100000};
+
+    if (numOfPolls < SCMDP_SPIN_LIMIT)
+    {
+        sched_yield();
+    }
+    else
+    {
+        nanosleep(&pause, NULL);
+    }
+#endif
+}
+
+long long _GetTime(void)
+{
+#ifdef _WIN32
+    return (long long)GetTickCount64() * 1000000LL;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+#endif
+}
+
+int _SplitLine(char *line, char *tokens[], int maxTokens)
+{
+    int numOfTokens = 0;
+    char *write;
+    char quote;
+
+    while (true)
+    {
+        while (*line == ' ' || *line == '\t' || *line == '\r')
+        {
+            line++;
+        }
+        if (*line == '\0')
+        {
+            break;
+        }
+        if (numOfTokens == maxTokens)
+        {
+            return -1;
+        }
+
+        /* Quotes and backslashes are removed, so the word is never longer than its source */
+        tokens[numOfTokens++] = write = line;
+        quote = 0;
+        while (*line != '\0' && (quote != 0 || (*line != ' ' && *line != '\t' && *line != '\r')))
+        {
+            if (quote == 0 && (*line == '"' || *line == '\''))
+            {
+                quote = *line++;
+            }
+            else if (quote != 0 && *line == quote)
+            {
+                quote = 0;
+                line++;
+            }
+            else if (*line == '\\' && quote != '\'' && line[1] != '\0')
+            {
+                line++;
+                *write++ = *line++;
+            }
+            else
+            {
+                *write++ = *line++;
+            }
+        }
+        if (*line != '\0')
+        {
+            line++;
+        }
+        *write = '\0';
+    }
+    tokens[numOfTokens] = NULL;
+    return numOfTokens;
+}
+
+char *_ReadConsoleLine(ScmdpConsole *console)
+{
+    char *newLine;
+    char *line;
+    int length;
+
+    if (console->readLine != NULL)
+    {
+        length = console->readLine(console->prompt, console->line, SCMDP_LINE_SIZE, console->readLineData);
+        if (length < 0)
+        {
+            return NULL;
+        }
+        console->line[(length < SCMDP_LINE_SIZE) ? length : SCMDP_LINE_SIZE - 1] = '\0';
+        return console->line;
+    }
+
+    if (console->prompt != NULL)
+    {
+        fputs(console->prompt, stdout);
+        fflush(stdout);
+    }
+
+    while (true)
+    {
+        newLine = memchr(console->line + console->lineStart, '\n', console->lineEnd - console->lineStart);
+        if (newLine != NULL)
+        {
+            *newLine = '\0';
+            line = console->line + console->lineStart;
+            console->lineStart = (int)(newLine - console->line) + 1;
+            if (console->isSkipping)
+            {
+                console->isSkipping = false;
+                continue;
+            }
+            if (newLine > line && newLine[-1] == '\r')
+            {
+                newLine[-1] = '\0';
+            }
+            return line;
+        }
+
+        /* The rest of data is moved to the beginning of buffer to read more */
+        memmove(console->line, console->line + console->lineStart, console->lineEnd - console->lineStart);
+        console->lineEnd -= console->lineStart;
+        console->lineStart = 0;
+        if (console->lineEnd == SCMDP_LINE_SIZE - 1)
+        {
+            if (!console->isSkipping)
+            {
+                console->numOfLongLines++;
+            }
+            console->isSkipping = true;
+            console->lineEnd = 0;
+        }
+
+        length = (int)read(console->fd, console->line + console->lineEnd, SCMDP_LINE_SIZE - 1 - console->lineEnd);
+        if (length <= 0)
+        {
+            /* The last line may have no line break */
+            if (console->lineEnd > 0 && !console->isSkipping)
+            {
+                console->line[console->lineEnd] = '\0';
+                console->lineEnd = 0;
+                return console->line;
+            }
+            return NULL;
+        }
+        console->lineEnd += length;
+    }
+}
+
+int _CompareKeyRefs(const void *left, const void *right)
+{
+    const ScmdpFoldedKeyRef *leftRef = left;
+    const ScmdpFoldedKeyRef *rightRef = right;
+    int result = strcmp(leftRef->folded, rightRef->folded);
+
+    return (result != 0) ? result : strcmp(leftRef->keyRef.key, rightRef->keyRef.key);
+}
+
+int _CompareFoldedKeys(ScmdpWorkspace *workspace, const char *left, const char *right, size_t length)
+{
+    unsigned char leftChar, rightChar;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        leftChar = workspace->foldedChars[(unsigned char)left[i]];
+        rightChar = workspace->foldedChars[(unsigned char)right[i]];
+        if (leftChar != rightChar || leftChar == '\0')
+        {
+            return (int)leftChar - (int)rightChar;
+        }
+    }
+    return 0;
+}
+
+bool _CompileWorkspace(ScmdpWorkspace *workspace)
+{
+    int numOfKeys = 0;
+    ScmdpFoldedKeyRef *foldedRefs;
+    char *foldedPool;
+    char *keys[2];
+    int lastGroup;
+    ScmdpHotKey *hotKey;
+    int length;
+    unsigned int hash;
+
+    /* Every optional argument gives two keys at most and help argument gives two more */
+    free(workspace->keyIndex);
+    free(workspace->hotKeys);
+    free(workspace->keyPool);
+    workspace->keyIndex = malloc(sizeof(ScmdpKeyRef) * (2 * workspace->numOfOptArgs + 2));
+    workspace->keyPoolSize = 0;
+    for (int i = -1; i < workspace->numOfOptArgs; i++)
+    {
+        keys[0] = (i == SCMDP_HELP_ID) ? workspace->helpArg.longHelpKey : workspace->optArgs[i].longKey;
+        keys[1] = (i == SCMDP_HELP_ID) ? workspace->helpArg.shortHelpKey : workspace->optArgs[i].shortKey;
+        for (int j = 0; j < 2; j++)
+        {
+            workspace->keyPoolSize += (keys[j] != NULL) ? (int)strlen(keys[j]) + 1 : 0;
+        }
+    }
+    workspace->keyPool = malloc(workspace->keyPoolSize + 1);
+
+    /* Hash table is at most half full, so every check of repeated key costs a probe or two */
+    workspace->hotKeysMask = 1;
+    while (workspace->hotKeysMask < 4 * workspace->numOfOptArgs + 4)
+    {
+        workspace->hotKeysMask <<= 1;
+    }
+    workspace->hotKeys = calloc(workspace->hotKeysMask, sizeof(ScmdpHotKey));
+    workspace->hotKeysMask -= 1;
+    if (workspace->hotCache != NULL)
+    {
+        /* Positions of cached keys are not valid for the new table */
+        memset(workspace->hotCache->slots, 0, sizeof(workspace->hotCache->slots));
+    }
+    workspace->keyPoolSize = 0;
+    workspace->compileError = ERR_NONE;
+
+    for (int i = -1; i < workspace->numOfOptArgs; i++)
+    {
+        keys[0] = (i == SCMDP_HELP_ID) ? workspace->helpArg.longHelpKey : workspace->optArgs[i].longKey;
+        keys[1] = (i == SCMDP_HELP_ID) ? workspace->helpArg.shortHelpKey : workspace->optArgs[i].shortKey;
+        for (int j = 0; j < 2; j++)
+        {
+            /* Empty keys can't be entered, so they are not indexed */
+            if (keys[j] == NULL || *keys[j] == '\0')
+            {
+                continue;
+            }
+            length = (int)strlen(keys[j]);
+            /* Length of indexed key is 16 bits, a longer key couldn't be matched */
+            if (length > 0xFFFF)
+            {
+                if (workspace->compileError == ERR_NONE)
+                {
+                    workspace->compileError = ERR_TOO_LONG_KEY;
+                    workspace->repeatedOptIds[0] = i;
+                    workspace->repeatedOptIds[1] = -1;
+                }
+                continue;
+            }
+
+            hash = _HashKey(workspace, keys[j], length);
+            hotKey = _FindHotKey(workspace, keys[j], length, hash);
+            if (hotKey->length != 0)
+            {
+                /* Long and short keys of the same argument may be equal, it's harmless */
+                if (hotKey->id != i && workspace->compileError == ERR_NONE)
+                {
+                    workspace->compileError = ERR_REPEATED_KEY;
+                    workspace->repeatedOptIds[0] = i;
+                    workspace->repeatedOptIds[1] = hotKey->id;
+                }
+                continue;
+            }
+
+            /* Key is interned into the pool, the index and the table refer to the same copy */
+            hotKey->hash = hash;
+            hotKey->offset = (unsigned int)workspace->keyPoolSize;
+            hotKey->length = (unsigned short)length;
+            hotKey->isValuable = (i != SCMDP_HELP_ID && workspace->optArgs[i].isValuable);
+            hotKey->id = i;
+            memcpy(workspace->keyPool + workspace->keyPoolSize, keys[j], length + 1);
+            workspace->keyIndex[numOfKeys].key = workspace->keyPool + workspace->keyPoolSize;
+            workspace->keyIndex[numOfKeys].id = i;
+            workspace->keyPoolSize += length + 1;
+            numOfKeys++;
+        }
+    }
+
+    /* Index is sorted as the keys are matched, so prefix search of completion finds the keys of any case */
+    foldedPool = malloc(workspace->keyPoolSize + 1);
+    foldedRefs = malloc(sizeof(ScmdpFoldedKeyRef) * (numOfKeys + 1));
+    for (int i = 0; i < workspace->keyPoolSize; i++)
+    {
+        foldedPool[i] = (char)workspace->foldedChars[(unsigned char)workspace->keyPool[i]];
+    }
+    for (int i = 0; i < numOfKeys; i++)
+    {
+        foldedRefs[i].folded = foldedPool + (workspace->keyIndex[i].key - workspace->keyPool);
+        foldedRefs[i].keyRef = workspace->keyIndex[i];
+    }
+    qsort(foldedRefs, numOfKeys, sizeof(ScmdpFoldedKeyRef), _CompareKeyRefs);
+    for (int i = 0; i < numOfKeys; i++)
+    {
+        workspace->keyIndex[i] = foldedRefs[i].keyRef;
+    }
+    free(foldedRefs);
+    free(foldedPool);
+    workspace->numOfKeys = numOfKeys;
+
+    /* Every group of constraints becomes one rule with bitmask over option ids */
+    free(workspace->rules);
+    free(workspace->ruleMasks);
+    workspace->numOfMaskWords = workspace->numOfOptArgs / 64 + 1;
+    workspace->rules = malloc(sizeof(ScmdpRule) * (workspace->numOfConstraints + 1));
+    workspace->ruleMasks = calloc((size_t)(workspace->numOfConstraints + 1) * workspace->numOfMaskWords, sizeof(unsigned long long));
+    workspace->numOfRules = 0;
+    lastGroup = -1;
+    for (int i = 0; i < workspace->numOfConstraints; i++)
+    {
+        ScmdpConstraint *constraint = &workspace->constraints[i];
+        int optId = _FindOptId(workspace, constraint->key);
+        int otherOptId = _FindOptId(workspace, constraint->otherKey);
+        unsigned long long *mask;
+
+        if (optId < 0 || otherOptId < 0)
+        {
+            /* Constraint is left out, the known option of it is kept for the message */
+            if (workspace->compileError == ERR_NONE)
+            {
+                workspace->compileError = ERR_UNKNOWN_CONSTRAINT_KEY;
+                workspace->repeatedOptIds[0] = (optId >= 0) ? optId : otherOptId;
+                workspace->repeatedOptIds[1] = -1;
+            }
+            continue;
+        }
+        if (constraint->group != lastGroup)
+        {
+            lastGroup = constraint->group;
+            workspace->rules[workspace->numOfRules].kind = constraint->kind;
+            workspace->rules[workspace->numOfRules].optId = optId;
+            workspace->numOfRules++;
+        }
+        mask = workspace->ruleMasks + (size_t)(workspace->numOfRules - 1) * workspace->numOfMaskWords;
+        mask[otherOptId >> 6] |= 1ULL << (otherOptId & 63);
+        if (constraint->kind == SCMDP_ONE_OF)
+        {
+            mask[optId >> 6] |= 1ULL << (optId & 63);
+        }
+    }
+    /* Arguments may be changed since the last formatting, names are built again when needed */
+    free(workspace->jsonKeys);
+    free(workspace->jsonKeyOffsets);
+    workspace->jsonKeys = NULL;
+    workspace->jsonKeyOffsets = NULL;
+    workspace->isCompiled = true;
+    return workspace->compileError == ERR_NONE;
+}
+
+bool _CheckCompileError(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    if (workspace->compileError == ERR_NONE)
+    {
+        return true;
+    }
+    context->error.optId = workspace->repeatedOptIds[0];
+    context->error.otherOptId = workspace->repeatedOptIds[1];
+    return _SetParseError(context, workspace->compileError, 0);
+}
+
+ScmdpHotKey *_FindHotKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash)
+{
+    ScmdpHotKey *hotKey = &workspace->hotKeys[hash & workspace->hotKeysMask];
+
+    /* The pool is read only when the hash and length are the same */
+    while (hotKey->length != 0 && (hotKey->hash != hash || hotKey->length != length || !_EqualKeys(workspace, workspace->keyPool + hotKey->offset, key, length)))
+    {
+        hotKey = &workspace->hotKeys[(hotKey - workspace->hotKeys + 1) & workspace->hotKeysMask];
+    }
+    return hotKey;
+}
+
+ScmdpHotKey *_MatchKey(ScmdpWorkspace *workspace, char *key, char **value)
+{
+    ScmdpHotKey *hotKey;
+    unsigned int hash = 2166136261u;
+    int length = 0;
+
+    /* One lookup finds both the end of argument and separator, so the profile adds no checks per character */
+    for (; !(workspace->charClasses[(unsigned char)key[length]] & SCMDP_CHAR_KEY_END); length++)
+    {
+        hash ^= workspace->foldedChars[(unsigned char)key[length]];
+        hash *= 16777619u;
+    }
+    *value = (key[length] != '\0') ? key + length + 1 : NULL;
+    if (length == 0 || length > 0xFFFF)
+    {
+        return NULL;
+    }
+    if (workspace->overlay != NULL)
+    {
+        return _MatchOverlayKey(workspace, key, length, hash);
+    }
+    if (workspace->hotCache != NULL && (hotKey = _FindCachedKey(workspace, key, length, hash)) != NULL)
+    {
+        return hotKey;
+    }
+    hotKey = _FindHotKey(workspace, key, length, hash);
+    return (hotKey->length != 0) ? hotKey : NULL;
+}
+
+ScmdpHotKey *_FindCachedKey(ScmdpWorkspace *workspace, char *key, int length, unsigned int hash)
+{
+    long long *slots = workspace->hotCache->slots[SCMDP_ATOMIC_LOAD(&workspace->hotCache->current)];
+    unsigned long long slot;
+    ScmdpHotKey *hotKey;
+
+    for (int i = 0; i < SCMDP_HOT_CACHE_SIZE; i++)
+    {
+        slot = (unsigned long long)SCMDP_ATOMIC_LOAD(&slots[i]);
+        if (slot == 0)
+        {
+            break;
+        }
+        if ((unsigned int)(slot >> 32) != hash)
+        {
+            continue;
+        }
+        /* Slot may be stale, but it always points to a real entry, so the entry itself is checked */
+        hotKey = &workspace->hotKeys[(slot & 0xFFFFFFFFu) - 1];
+        if (hotKey->length == length && _EqualKeys(workspace, workspace->keyPool + hotKey->offset, key, length))
+        {
+            return hotKey;
+        }
+    }
+    return NULL;
+}
+
+void _RefreshHotCache(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    ScmdpHotCache *cache = workspace->hotCache;
+    int ids[SCMDP_HOT_CACHE_SIZE];
+    long long counts[SCMDP_HOT_CACHE_SIZE];
+    int numOfIds = 0;
+    int numOfSlots = 0;
+    long long *slots;
+    long long count;
+    char *keys[2];
+    ScmdpHotKey *hotKey;
+    int next, j;
+
+    for (int i = 0; i < context->numOfOptArgs; i++)
+    {
+        if (context->matchCounts[i] != 0)
+        {
+            SCMDP_ATOMIC_ADD(&cache->totals[i], (long long)context->matchCounts[i]);
+            context->matchCounts[i] = 0;
+        }
+    }
+    context->numOfTracked = 0;
+    if (!SCMDP_ATOMIC_CAS(&cache->isRebuilding, 0, 1))
+    {
+        return;
+    }
+
+    /* Every option gives two keys at most, so the most used options are kept in a small sorted array */
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        count = SCMDP_ATOMIC_LOAD(&cache->totals[i]);
+        /* Old matches weigh less after every rebuild, so the cache follows the changes of usage */
+        SCMDP_ATOMIC_ADD(&cache->totals[i], -(count / 2));
+        if (count == 0 || (numOfIds == SCMDP_HOT_CACHE_SIZE / 2 && count <= counts[numOfIds-1]))
+        {
+            continue;
+        }
+        j = (numOfIds < SCMDP_HOT_CACHE_SIZE / 2) ? numOfIds++ : numOfIds - 1;
+        for (; j > 0 && counts[j-1] < count; j--)
+        {
+            ids[j] = ids[j-1];
+            counts[j] = counts[j-1];
+        }
+        ids[j] = i;
+        counts[j] = count;
+    }
+
+    /* Parsers still reading the other buffer see valid slots only, so it's filled in place */
+    next = 1 - (int)SCMDP_ATOMIC_LOAD(&cache->current);
+    slots = cache->slots[next];
+    for (int i = 0; i < numOfIds; i++)
+    {
+        keys[0] = workspace->optArgs[ids[i]].longKey;
+        keys[1] = workspace->optArgs[ids[i]].shortKey;
+        for (int k = 0; k < 2; k++)
+        {
+            if (*keys[k] == '\0' || strlen(keys[k]) > 0xFFFF)
+            {
+                continue;
+            }
+            hotKey = _FindHotKey(workspace, keys[k], (int)strlen(keys[k]), _HashKey(workspace, keys[k], (int)strlen(keys[k])));
+            if (hotKey->length != 0 && hotKey->id == ids[i])
+            {
+                SCMDP_ATOMIC_STORE(&slots[numOfSlots++], (long long)(((unsigned long long)hotKey->hash << 32) | (unsigned long long)(hotKey - workspace->hotKeys + 1)));
+            }
+        }
+    }
+    for (int i = numOfSlots; i < SCMDP_HOT_CACHE_SIZE; i++)
+    {
+        SCMDP_ATOMIC_STORE(&slots[i], 0);
+    }
+    SCMDP_ATOMIC_STORE(&cache->current, (long long)next);
+    SCMDP_ATOMIC_STORE(&cache->isRebuilding, 0);
+}
+
+int _FindOptId(ScmdpWorkspace *workspace, char *key)
+{
+    char *value;
+    ScmdpHotKey *hotKey = _MatchKey(workspace, key, &value);
+
+    return (hotKey != NULL && value == NULL) ? hotKey->id : -1;
+}
+
+bool _ConvertOptVals(ScmdpWorkspace *workspace, ScmdpParseContext *context, bool isDefault)
+{
+    int count;
+    bool isPresent;
+
+    /* Arena may move while it grows, so values converted before become positions until all values are converted */
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        if (context->typedVals[i].count > 0)
+        {
+            context->typedVals[i].values = (long long *)(size_t)(context->typedVals[i].values - context->arena);
+        }
+    }
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        isPresent = (context->presentBits[i >> 6] >> (i & 63)) & 1;
+        if (workspace->optTypes[i].type == SCMDP_TYPE_TEXT || context->optVals[i] == NULL || isPresent == isDefault)
+        {
+            continue;
+        }
+
+        context->typedVals[i].values = (long long *)(size_t)context->arenaUsed;
+        switch (workspace->optTypes[i].type)
+        {
+        case SCMDP_TYPE_INT_LIST:
+        case SCMDP_TYPE_RANGE_LIST:
+            count = _ParseNumberList(context, context->optVals[i], workspace->optTypes[i].type == SCMDP_TYPE_RANGE_LIST);
+            break;
+        case SCMDP_TYPE_SIZE:
+        case SCMDP_TYPE_DURATION:
+            count = _ReserveArena(context, 1) ? 1 : -1;
+            if (count > 0 && !(workspace->optTypes[i].type == SCMDP_TYPE_SIZE ?
+                _ParseQuantity(context->optVals[i], _sizeUnits, sizeof(_sizeUnits) / sizeof(ScmdpUnit), false, &context->arena[context->arenaUsed]) :
+                _ParseQuantity(context->optVals[i], _durationUnits, sizeof(_durationUnits) / sizeof(ScmdpUnit), true, &context->arena[context->arenaUsed])))
+            {
+                count = -1;
+            }
+            context->arenaUsed += (count > 0) ? 1 : 0;
+            break;
+        default:
+            count = -1;
+            break;
+        }
+        if (count < 0)
+        {
+            context->error.optId = i;
+            return _SetParseError(context, ERR_WRONG_NUMBER, 0);
+        }
+        context->typedVals[i].count = count;
+    }
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        if (context->typedVals[i].count > 0)
+        {
+            context->typedVals[i].values = context->arena + (size_t)context->typedVals[i].values;
+        }
+    }
+    return true;
+}
+
+int _ParseNumberList(ScmdpParseContext *context, char *value, bool keepRanges)
+{
+    char *cursor = value;
+    char *end = value + strlen(value);
+    long long first, last;
+    unsigned long long span;
+    int count = 0;
+
+    while (true)
+    {
+        if (!_ParseInteger(&cursor, end, &first))
+        {
+            return -1;
+        }
+        last = first;
+        if (*cursor == '-')
+        {
+            cursor++;
+            if (!_ParseInteger(&cursor, end, &last) || last < first)
+            {
+                return -1;
+            }
+        }
+
+        if (keepRanges)
+        {
+            if (!_ReserveArena(context, 2))
+            {
+                return -1;
+            }
+            context->arena[context->arenaUsed++] = first;
+            context->arena[context->arenaUsed++] = last;
+            count++;
+        }
+        else
+        {
+            /* Difference is counted without sign and checked before adding one, the widest range would wrap to 0 */
+            span = (unsigned long long)last - (unsigned long long)first;
+            if (span >= SCMDP_MAX_NUMBERS || !_ReserveArena(context, span + 1))
+            {
+                return -1;
+            }
+            for (long long number = first; ; number++)
+            {
+                context->arena[context->arenaUsed++] = number;
+                count++;
+                if (number == last)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (cursor == end)
+        {
+            return count;
+        }
+        if (*cursor++ != ',')
+        {
+            return -1;
+        }
+    }
+}
+
+bool _ParseQuantity(char *value, const ScmdpUnit *units, int numOfUnits, bool isSequence, long long *number)
+{
+    const unsigned long long limit = 9223372036854775807ULL;
+    unsigned long long total = 0;
+    unsigned long long whole, fraction, scale, multiplier, amount;
+    char *cursor = value;
+    char *suffix;
+
+    do
+    {
+        whole = 0;
+        fraction = 0;
+        scale = 1;
+        suffix = cursor;
+        while (*cursor >= '0' && *cursor <= '9')
+        {
+            if (whole > (limit - (unsigned long long)(*cursor - '0')) / 10)
+            {
+                return false;
+            }
+            whole = whole * 10 + (unsigned long long)(*cursor++ - '0');
+        }
+        if (*cursor == '.')
+        {
+            /* Nine digits of fraction are enough for nanoseconds, the next ones are dropped */
+            cursor++;
+            for (; *cursor >= '0' && *cursor <= '9'; cursor++)
+            {
+                if (scale < 1000000000ULL)
+                {
+                    fraction = fraction * 10 + (unsigned long long)(*cursor - '0');
+                    scale *= 10;
+                }
+            }
+        }
+        if (cursor == suffix || (cursor == suffix + 1 && *suffix == '.'))
+        {
+            return false;
+        }
+
+        suffix = cursor;
+        while (*cursor != '\0' && (!isSequence || ((*cursor < '0' || *cursor > '9') && *cursor != '.')))
+        {
+            cursor++;
+        }
+        multiplier = _MatchUnit(units, numOfUnits, suffix, (int)(cursor - suffix));
+        if (multiplier == 0 || whole > limit / multiplier)
+        {
+            return false;
+        }
+
+        /* Fraction is multiplied by parts, so neither product can overflow */
+        amount = whole * multiplier;
+        fraction = (multiplier / scale) * fraction + (multiplier % scale) * fraction / scale;
+        if (amount > limit - fraction || total > limit - amount - fraction)
+        {
+            return false;
+        }
+        total += amount + fraction;
+    }
+    while (isSequence && *cursor != '\0');
+
+    *number = (long long)total;
+    return true;
+}
+
+unsigned long long _MatchUnit(const ScmdpUnit *units, int numOfUnits, char *suffix, int length)
+{
+    for (int i = 0; i < numOfUnits; i++)
+    {
+        if (units[i].length == length && memcmp(units[i].suffix, suffix, length) == 0)
+        {
+            return units[i].multiplier;
+        }
+    }
+    return 0;
+}
+
+bool _ParseInteger(char **cursor, char *end, long long *number)
+{
+    char *digits = *cursor;
+    char *start;
+    unsigned long long value = 0;
+    unsigned long long limit = 9223372036854775807ULL;
+    unsigned long long chunk;
+    bool isNegative = (*digits == '-');
+
+    if (isNegative)
+    {
+        digits++;
+        limit += 1;
+    }
+    start = digits;
+
+#if SCMDP_SWAR_DIGITS
+    /* Long numbers go by eight digits, the tail and short numbers go one by one */
+    while (end - digits >= 8 && _ParseEightDigits(digits, &chunk))
+    {
+        if (value > (limit - chunk) / 100000000ULL)
+        {
+            return false;
+        }
+        value = value * 100000000ULL + chunk;
+        digits += 8;
+    }
+#endif
+    while (digits < end && *digits >= '0' && *digits <= '9')
+    {
+        chunk = (unsigned long long)(*digits - '0');
+        if (value > (limit - chunk) / 10)
+        {
+            return false;
+        }
+        value = value * 10 + chunk;
+        digits++;
+    }
+    if (digits == start)
+    {
+        return false;
+    }
+
+    *number = isNegative ? -(long long)(value - 1) - 1 : (long long)value;
+    *cursor = digits;
+    return true;
+}
+
+bool _ParseEightDigits(const char *digits, unsigned long long *value)
+{
+    unsigned long long chunk;
+
+    memcpy(&chunk, digits, 8);
+
+    /* Every byte is a digit if its high half is 3 and adding 6 doesn't make it 4 */
+    if ((chunk & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL ||
+        ((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL)
+    {
+        return false;
+    }
+
+    /* Neighbour digits are joined into pairs, pairs into fours and fours into the number */
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    *value = ((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+    return true;
+}
+
+bool _ReserveArena(ScmdpParseContext *context, unsigned long long count)
+{
+    if (count > (unsigned long long)(SCMDP_MAX_NUMBERS - context->arenaUsed))
+    {
+        return false;
+    }
+    if (context->arenaUsed + (int)count > context->arenaSize)
+    {
+        context->arenaSize = (context->arenaUsed + (int)count) * 2;
+        context->arena = realloc(context->arena, sizeof(long long) * context->arenaSize);
+    }
+    return true;
+}
+
+char *_OptArgName(ScmdpWorkspace *workspace, int id)
+{
+    /* Ids of options added by overlay follow the ids of base */
+    if (workspace->overlay != NULL && id >= workspace->numOfOptArgs)
+    {
+        return _OptArgName(&workspace->overlay->added, id - workspace->numOfOptArgs);
+    }
+    if (workspace->optArgs[id].longKey != NULL && *workspace->optArgs[id].longKey != '\0')
+    {
+        return workspace->optArgs[id].longKey;
+    }
+    return workspace->optArgs[id].shortKey;
+}
+
+bool _CheckConstraints(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    unsigned long long *present = context->presentBits;
+    unsigned long long *mask;
+    unsigned long long violated;
+    bool isOwnerPresent;
+    bool isAnyPresent;
+
+    for (int i = 0; i < workspace->numOfRules; i++)
+    {
+        ScmdpRule *rule = &workspace->rules[i];
+        mask = workspace->ruleMasks + (size_t)i * workspace->numOfMaskWords;
+        isOwnerPresent = (present[rule->optId >> 6] >> (rule->optId & 63)) & 1;
+        isAnyPresent = false;
+
+        for (int w = 0; w < workspace->numOfMaskWords; w++)
+        {
+            /* Required options which are absent or conflicting options which are present */
+            violated = 0;
+            if (rule->kind == SCMDP_REQUIRES && isOwnerPresent)
+            {
+                violated = mask[w] & ~present[w];
+            }
+            else if (rule->kind == SCMDP_CONFLICTS && isOwnerPresent)
+            {
+                violated = mask[w] & present[w];
+            }
+            else if (rule->kind == SCMDP_ONE_OF)
+            {
+                isAnyPresent = isAnyPresent || (mask[w] & present[w]) != 0;
+            }
+
+            if (violated != 0)
+            {
+                context->error.optId = rule->optId;
+                context->error.otherOptId = w * 64;
+                while ((violated & 1) == 0)
+                {
+                    violated >>= 1;
+                    context->error.otherOptId++;
+                }
+                return _SetParseError(context, (rule->kind == SCMDP_REQUIRES) ? ERR_REQUIRED_OPTION : ERR_CONFLICTING_OPTIONS, 0);
+            }
+        }
+        if (rule->kind == SCMDP_ONE_OF && !isAnyPresent)
+        {
+            context->error.optId = rule->optId;
+            return _SetParseError(context, ERR_NO_OPTION_OF_GROUP, 0);
+        }
+    }
+    return true;
+}
+
+bool _RunOptHooks(ScmdpWorkspace *workspace, ScmdpParseContext *context)
+{
+    ScmdpOverlay *overlay = workspace->overlay;
+    ScmdpOverlayDefault *overlayDefault;
+    ScmdpOptHooks *hooks;
+    bool isPresent;
+    bool isDefaulted = false;
+    int optId;
+
+    /* Defaults of overlay go first, so providers of base are not called for the options they replace */
+    for (int i = 0; overlay != NULL && i < overlay->numOfDefaults; i++)
+    {
+        overlayDefault = &overlay->defaults[i];
+        optId = overlayDefault->optId;
+        if (!((context->presentBits[optId >> 6] >> (optId & 63)) & 1) && !_IsHidden(workspace, optId))
+        {
+            context->optVals[optId] = overlayDefault->provideDefault(optId, overlayDefault->defaultData);
+            isDefaulted = isDefaulted || (context->optVals[optId] != NULL);
+        }
+    }
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        /* Hidden options can't be entered and get no default, their typed values are cleared too */
+        if (overlay != NULL && _IsHidden(workspace, i))
+        {
+            context->optVals[i] = NULL;
+            context->typedVals[i].count = 0;
+            continue;
+        }
+        if (workspace->optHooks == NULL)
+        {
+            continue;
+        }
+        hooks = &workspace->optHooks[i];
+        isPresent = (context->presentBits[i >> 6] >> (i & 63)) & 1;
+        if (isPresent && hooks->action != NULL && !hooks->action(i, context->optVals[i], hooks->actionData))
+        {
+            context->error.optId = i;
+            return _SetParseError(context, ERR_REJECTED_VALUE, 0);
+        }
+        /* Absent argument keeps NULL value and stays unmarked, so constraints don't see defaults */
+        if (!isPresent && context->optVals[i] == NULL && hooks->provideDefault != NULL)
+        {
+            context->optVals[i] = hooks->provideDefault(i, hooks->defaultData);
+            isDefaulted = isDefaulted || (context->optVals[i] != NULL);
+        }
+    }
+    /* Entered values are converted before the actions see them, defaults only now */
+    if (isDefaulted && workspace->optTypes != NULL)
+    {
+        return _ConvertOptVals(workspace, context, true);
+    }
+    return true;
+}
+
+ScmdpOptHooks *_GetOptHooks(ScmdpWorkspace *workspace, int optId)
+{
+    if (optId < 0 || optId >= workspace->numOfOptArgs)
+    {
+        return NULL;
+    }
+    if (workspace->optHooks == NULL)
+    {
+        workspace->optHooks = calloc(workspace->numOfOptArgs, sizeof(ScmdpOptHooks));
+    }
+    return &workspace->optHooks[optId];
+}
+
+ScmdpFlagOut *_GetFlagOut(ScmdpWorkspace *workspace, int optId)
+{
+    if (optId < 0 || optId >= workspace->numOfOptArgs || workspace->optArgs[optId].isValuable)
+    {
+        return NULL;
+    }
+    if (workspace->flagOuts == NULL)
+    {
+        workspace->flagOuts = malloc(sizeof(ScmdpFlagOut) * workspace->numOfOptArgs);
+        for (int i = 0; i < workspace->numOfOptArgs; i++)
+        {
+            workspace->flagOuts[i].bit = -1;
+            workspace->flagOuts[i].isCounter = false;
+            workspace->flagOuts[i].countPlace = NULL;
+        }
+    }
+    return &workspace->flagOuts[optId];
+}
+
+ScmdpHotKey *_MatchArg(ScmdpWorkspace *workspace, char *key, int *count, char **value)
+{
+    ScmdpHotKey *hotKey = _MatchKey(workspace, key, value);
+    unsigned char *folded = workspace->foldedChars;
+    int length;
+    int runStart;
+
+    *count = 1;
+    if (hotKey != NULL && *value != NULL && !hotKey->isValuable)
+    {
+        return NULL;
+    }
+    if (hotKey != NULL || *value != NULL || workspace->flagOuts == NULL)
+    {
+        return hotKey;
+    }
+
+    /* The key of counter is the argument without the repeats of its last character */
+    length = (int)strlen(key);
+    runStart = length - 1;
+    while (runStart > 0 && folded[(unsigned char)key[runStart-1]] == folded[(unsigned char)key[length-1]])
+    {
+        runStart--;
+    }
+    if (length < 3 || runStart + 1 == length || runStart + 1 > 0xFFFF)
+    {
+        return NULL;
+    }
+    hotKey = _FindHotKey(workspace, key, runStart + 1, _HashKey(workspace, key, runStart + 1));
+    if (hotKey->length == 0 || hotKey->id < 0 || _IsHidden(workspace, hotKey->id) || !workspace->flagOuts[hotKey->id].isCounter)
+    {
+        return NULL;
+    }
+    *count = length - runStart;
+    return hotKey;
+}
+
+void _MarkFlag(ScmdpWorkspace *workspace, ScmdpParseContext *context, int optId)
+{
+    ScmdpFlagOut *flagOut;
+
+    context->optVals[optId] = "true";
+    SCMDP_MARK_PRESENT(context, optId);
+    /* Options added by overlay have no bits */
+    if (workspace->flagOuts == NULL || optId >= workspace->numOfOptArgs)
+    {
+        return;
+    }
+
+    flagOut = &workspace->flagOuts[optId];
+    if (flagOut->bit >= 0)
+    {
+        context->flagBits[flagOut->bit >> 6] |= 1ULL << (flagOut->bit & 63);
+    }
+}
+
+bool _CountEntry(ScmdpWorkspace *workspace, ScmdpParseContext *context, int optId, int count)
+{
+    if (context->matchCounts != NULL)
+    {
+        context->matchCounts[optId]++;
+    }
+    count += context->optCounts[optId];
+    context->optCounts[optId] = (count < 255) ? (unsigned char)count : 255;
+    return workspace->budget.maxRepeats <= 0 || count <= workspace->budget.maxRepeats;
+}
+
+int _LowerBoundKey(ScmdpWorkspace *workspace, char *key)
+{
+    int left = 0;
+    int right = workspace->numOfKeys;
+    int middle;
+
+    while (left < right)
+    {
+        middle = left + (right - left) / 2;
+        if (_CompareFoldedKeys(workspace, workspace->keyIndex[middle].key, key, (size_t)-1) < 0)
+        {
+            left = middle + 1;
+        }
+        else
+        {
+            right = middle;
+        }
+    }
+    return left;
+}
+
+void _ShowCompletions(ScmdpWorkspace *workspace, int numOfWords, char *words[], int cursor)
+{
+    char *prefix = "";
+    char *answer;
+    size_t prefixLength, keyLength;
+    size_t answerLength = 0;
+    int first, last, previous;
+
+    if (!workspace->isCompiled)
+    {
+        _CompileWorkspace(workspace);
+    }
+    if (cursor < numOfWords)
+    {
+        prefix = words[cursor];
+    }
+
+    /* A value is expected after the valuable key, so it's better to leave it for the shell (ex.: file names) */
+    if (cursor >= 2 && cursor <= numOfWords)
+    {
+        previous = _LowerBoundKey(workspace, words[cursor-1]);
+        if (previous < workspace->numOfKeys && _CompareFoldedKeys(workspace, workspace->keyIndex[previous].key, words[cursor-1], (size_t)-1) == 0)
+        {
+            if (workspace->keyIndex[previous].id != SCMDP_HELP_ID && workspace->optArgs[workspace->keyIndex[previous].id].isValuable)
+            {
+                return;
+            }
+        }
+    }
+
+    /* Non-optional arguments have free form values, so only keys are completed */
+    if (!(workspace->charClasses[(unsigned char)*prefix] & SCMDP_CHAR_PREFIX))
+    {
+        return;
+    }
 
-    if (strcmp(valName, "") != 0 && valName != NULL)
+    /* Keys with the same prefix lie together in sorted index, so the first one is found by binary search */
+    prefixLength = strlen(prefix);
+    first = _LowerBoundKey(workspace, prefix);
+    for (last = first; last < workspace->numOfKeys; last++)
     {
-        workspace->numOfValOptArgs += 1;
-        newOptArg.isValuable = true;
+        if (_CompareFoldedKeys(workspace, workspace->keyIndex[last].key, prefix, prefixLength) != 0)
+        {
+            break;
+        }
+        answerLength += strlen(workspace->keyIndex[last].key) + 1;
     }
-    else
+    if (answerLength == 0)
     {
-        newOptArg.isValuable = false;
+        return;
     }
 
-    workspace->numOfOptArgs += 1;
-    workspace->optArgs = realloc(workspace->optArgs, sizeof(ScmdpOptArg) * workspace->numOfOptArgs);
-    workspace->optArgs[workspace->numOfOptArgs-1] = newOptArg;
-}
-
-void AddNonOptArg(ScmdpWorkspace *workspace, char *key, char *help, char **valPlace)
-{
-    ScmdpNonOptArg newNonOptArg;
-    newNonOptArg.key = key;
-    newNonOptArg.help = help;
-    newNonOptArg.valPlace = valPlace;
-
-    workspace->numOfNonOptArgs += 1;
-    workspace->nonOptArgs = realloc(workspace->nonOptArgs, sizeof(ScmdpNonOptArg) * workspace->numOfNonOptArgs);
-    workspace->nonOptArgs[workspace->numOfNonOptArgs-1] = newNonOptArg;
+    answer = malloc(answerLength);
+    answerLength = 0;
+    for (int i = first; i < last; i++)
+    {
+        keyLength = strlen(workspace->keyIndex[i].key);
+        memcpy(answer + answerLength, workspace->keyIndex[i].key, keyLength);
+        answerLength += keyLength;
+        answer[answerLength++] = '\n';
+    }
+    fwrite(answer, 1, answerLength, stdout);
+    fflush(stdout);
+    free(answer);
 }
 
-bool ParseArgs(ScmdpWorkspace *workspace, int argc, char *argv[])
+bool _EqualKeys(ScmdpWorkspace *workspace, const char *key, const char *arg, int length)
 {
-    bool helpArgFound = false;
-    bool optArgFound = false;
-    bool success = true;    
-
-    /**
-    *   First you need to check if there is an argument that calls the help.
-    *   If it is present, then we call the _ShowHelp() function and exit the program
-    */
-    for (int i = 1; i < argc; i++)
+    /* Keys of the same hash and length are almost always equal, folding is needed only if the case differs */
+    if (memcmp(key, arg, length) == 0)
     {
-        if(strcmp(argv[i], workspace->helpArg.longHelpKey) == 0 || strcmp(argv[i], workspace->helpArg.shortHelpKey) == 0)
+        return true;
+    }
+    for (int i = 0; i < length; i++)
+    {
+        if (workspace->foldedChars[(unsigned char)key[i]] != workspace->foldedChars[(unsigned char)arg[i]])
         {
-            helpArgFound = true;
-            break;
+            return false;
         }
     }
+    return true;
+}
 
-    if (helpArgFound)
-    {
-        _ShowHelp(workspace, true);
-        success = false;
-    }
-    /* If help was not called, we go to analyze all the entered arguments */
-    else if (argc-1 > workspace->numOfNonOptArgs + workspace->numOfOptArgs + workspace->numOfValOptArgs)
+unsigned int _HashKey(ScmdpWorkspace *workspace, const char *key, int length)
+{
+    unsigned int hash = 2166136261u;
+
+    for (int i = 0; i < length; i++)
     {
-        _ShowHelp(workspace, false);
-        success = false;
+        hash ^= workspace->foldedChars[(unsigned char)key[i]];
+        hash *= 16777619u;
     }
-    else if (argc-1 < workspace->numOfNonOptArgs)
+    return hash;
+}
+
+void _BuildJsonKeys(ScmdpWorkspace *workspace)
+{
+    int numOfNames = workspace->numOfOptArgs + workspace->numOfNonOptArgs + 1;
+    ScmdpJsonWriter writer = {NULL, 0, 0};
+    unsigned int *offsets = NULL;
+    char *name;
+
+    /* Escaped character takes six bytes at most, comma, quotes and colon take four more */
+    for (int pass = 0; pass < 2; pass++)
     {
-        _ShowHelp(workspace, false);
-        success = false;
-    }
-    else
-    {   
-        /**
-        *   Check if the first argument is optional or not 
-        * 
-        *   You can choose the notation by yourself (for example '@')
-        *   By default there are presents UNIX notation '-' and Windows notation '/'
-        */
-        if (*argv[1] == '-' || *argv[1] == '/')
+        for (int i = 0; i < numOfNames; i++)
         {
-            /* If the first argument is optional, we go from the end to parse non-optional at first */
-            for (int i = argc - 1; i > argc - workspace->numOfNonOptArgs - 1; i--)
+            if (i < workspace->numOfOptArgs)
             {
-                if (*argv[i] == '-' || *argv[i] == '/')
+                /* Long key names the argument, prefixes are not a part of name */
+                name = workspace->optArgs[i].longKey;
+                if (name == NULL || *name == '\0')
                 {
-                    _ShowError(workspace, ERR_NO_VAL_NOPT_PARAMETER);
-                    success = false;
-                    break;
+                    name = (workspace->optArgs[i].shortKey != NULL) ? workspace->optArgs[i].shortKey : "";
                 }
-                else
+                while (workspace->charClasses[(unsigned char)*name] & SCMDP_CHAR_PREFIX)
                 {
-                    *(workspace->nonOptArgs[i - argc + workspace->numOfNonOptArgs].valPlace) = argv[i];
+                    name++;
                 }
             }
-            /* After non-optional arguments if parsing was succesful we come back to begin and parse optional ones */
-            if (success)
+            else if (i < numOfNames - 1)
             {
-                for(int i = 1; i < argc - workspace->numOfNonOptArgs; i++)
-                {
-                    if (*argv[i] == '-' || *argv[i] == '/')
-                    {
-                        optArgFound = false;
-                        for (int j = 0; j < workspace->numOfOptArgs; j++)
-                        {
-                            if(strcmp(argv[i], workspace->optArgs[j].longKey) == 0 || strcmp(argv[i], workspace->optArgs[j].shortKey) == 0)
-                            {
-                                optArgFound = true;
-                                if(workspace->optArgs[j].isValuable)
-                                {
-                                    if((i + 1 > argc - workspace->numOfNonOptArgs - 1) || (*argv[i+1] == '-' || *argv[i+1] == '/'))
-                                    {
-                                        _ShowError(workspace, ERR_NO_VAL_OPT_PARAMETER);
-                                        success = false;
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        *(workspace->optArgs[j].valPlace) = argv[i+1];
-                                        ++i;
-                                    }
-                                }
-                                else
-                                {
-                                    *(workspace->optArgs[j].valPlace) = "true";
-                                }
-                            }
-                        }
-                        if(success)
-                        {
-                            if (!optArgFound)
-                            {
-                                _ShowError(workspace, ERR_UNKNOWN_PARAMETER);
-                                success = false;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        _ShowError(workspace, ERR_WRONG_SYNTAX);
-                        success = false;
-                        break;
-                    }
-                }
+                name = workspace->nonOptArgs[i - workspace->numOfOptArgs].key;
             }
-        }
-        else
-        {
-            /* If the first argument is non-optional, we go parse arguments in direct order */
-            for (int i = 1; i < workspace->numOfNonOptArgs+1; i++)
+            else
             {
-                if (*argv[i] == '-' || *argv[i] == '/')
-                {
-                    _ShowError(workspace, ERR_NO_VAL_NOPT_PARAMETER);
-                    success = false;
-                    break;
-                }
-                else
-                {
-                    *(workspace->nonOptArgs[i-1].valPlace) = argv[i];
-                }
+                name = workspace->restArg.key;
             }
-            if (success)
+
+            if (pass == 0)
             {
-                /* Separate loop for parsing optional arguments in direct order */
-                for (int i = workspace->numOfNonOptArgs+1; i < argc; i++)
-                {
-                    optArgFound = false;
-                    for (int j = 0; j < workspace->numOfOptArgs; j++)
-                    {
-                        if(strcmp(argv[i], workspace->optArgs[j].longKey) == 0 || strcmp(argv[i], workspace->optArgs[j].shortKey) == 0)
-                        {
-                            optArgFound = true;
-                            if(workspace->optArgs[j].isValuable)
-                            {
-                                if((i+1 >= argc) || (*argv[i+1] == '-' || *argv[i+1] == '/'))
-                                {
-                                    _ShowError(workspace, ERR_NO_VAL_OPT_PARAMETER);
-                                    success = false;
-                                    break;
-                                }
-                                else
-                                {
-                                    *(workspace->optArgs[j].valPlace) = argv[i+1];
-                                    ++i;
-                                }
-                            }
-                            else
-                            {
-                                *(workspace->optArgs[j].valPlace) = "true";
-                            }
-                        }
-                    }
-                    if(success)
-                    {
-                        if (!optArgFound)
-                        {
-                            _ShowError(workspace, ERR_UNKNOWN_PARAMETER);
-                            success = false;
-                            break;
-                        }
-                    }
-                }
+                writer.size += 6 * strlen(name) + 4;
+                continue;
             }
+            offsets[i] = (unsigned int)writer.length;
+            _WriteJson(&writer, ",", 1);
+            _WriteJsonString(&writer, name);
+            _WriteJson(&writer, ":", 1);
+        }
+        if (pass == 0)
+        {
+            writer.buffer = malloc(writer.size + 1);
+            offsets = malloc(sizeof(unsigned int) * (numOfNames + 1));
         }
     }
-    /** Now release the memory! 
-     * Everything is scattered into variables or error message was issued
-     * We don't need workspace anymore! */
-    _DeleteWorkspace(workspace);
-    return success;
-}    
+    offsets[numOfNames] = (unsigned int)writer.length;
+
+    /* Offsets are published before names, so whoever sees the names sees the offsets too */
+    if (!SCMDP_ATOMIC_CAS_POINTER(&workspace->jsonKeyOffsets, NULL, offsets))
+    {
+        free(offsets);
+    }
+    if (!SCMDP_ATOMIC_CAS_POINTER(&workspace->jsonKeys, NULL, writer.buffer))
+    {
+        free(writer.buffer);
+    }
+}
 
-void _ShowError(ScmdpWorkspace *workspace, int errorCode)
+void _WriteJson(ScmdpJsonWriter *writer, const char *data, size_t length)
 {
-    char *error;
-    switch (errorCode)
+    if (writer->length + length <= writer->size)
     {
-    case ERR_NO_VAL_NOPT_PARAMETER:
-        error = "Error: Need a value for non-optional parameter!";
-        break;
-    case ERR_NO_VAL_OPT_PARAMETER:
-        error = "Error: Need a value for optional parameter!";
-        break;
-    case ERR_UNKNOWN_PARAMETER:
-        error = "Error: Unknown argument or option!";
-        break;
-    case ERR_WRONG_PARS_NUMBER:
-        error = "Error: Wrong number of parameters!";
-        break;
-    case ERR_WRONG_SYNTAX:
-        error = "Error: Wrong command line syntax!";
-        break;
-    default:
-        break;
+        memcpy(writer->buffer + writer->length, data, length);
     }
-    printf("%s\nprint -h or --help to see help\n", error);
+    writer->length += length;
 }
 
-void _ShowHelp(ScmdpWorkspace *workspace, bool showFullHelp)
+void _WriteJsonString(ScmdpJsonWriter *writer, const char *value)
 {
-    char checkSymbol = 0;
-    if(!showFullHelp)
+    static const char hexDigits[] = "0123456789abcdef";
+    char escape[6] = {'\\', 'u', '0', '0', '0', '0'};
+    unsigned char code;
+    size_t run;
+
+    _WriteJson(writer, "\"", 1);
+    while (true)
     {
-        printf("%s\n", workspace->syntaxHelp);
+        run = 0;
+        while (_jsonEscapes[(unsigned char)value[run]] == 0)
+        {
+            run++;
+        }
+        _WriteJson(writer, value, run);
+        value += run;
+        code = _jsonEscapes[(unsigned char)*value];
+        if (code == 1)
+        {
+            break;
+        }
+        if (code == 'u')
+        {
+            escape[1] = 'u';
+            escape[4] = hexDigits[(unsigned char)*value >> 4];
+            escape[5] = hexDigits[(unsigned char)*value & 15];
+            _WriteJson(writer, escape, 6);
+        }
+        else
+        {
+            escape[1] = (char)code;
+            _WriteJson(writer, escape, 2);
+        }
+        value++;
     }
-    else
+    _WriteJson(writer, "\"", 1);
+}
+
+void _WriteJsonNumber(ScmdpJsonWriter *writer, long long number)
+{
+    char digits[24];
+    int position = sizeof(digits);
+    unsigned long long magnitude = (number < 0) ? 0ULL - (unsigned long long)number : (unsigned long long)number;
+
+    /* Digits are written from the end, so they are copied at once */
+    do
     {
-        printf("%s\n\n%s\n", workspace->syntaxHelp, workspace->descriptHelp);
-        
-        printf("\n>> Non-optional arguments:\n");
-        for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+        digits[--position] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (number < 0)
+    {
+        digits[--position] = '-';
+    }
+    _WriteJson(writer, digits + position, sizeof(digits) - position);
+}
+
+unsigned int _HashBytes(const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    unsigned int hash = 2166136261u;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+size_t _AlignBlobSize(size_t size)
+{
+    return (size + 7) & ~(size_t)7;
+}
+
+char *_SaveBlobString(char *blob, size_t *poolEnd, char *string)
+{
+    size_t offset = *poolEnd;
+    size_t length;
+
+    if (string == NULL)
+    {
+        return NULL;
+    }
+
+    length = strlen(string) + 1;
+    if (blob != NULL)
+    {
+        memcpy(blob + offset, string, length);
+    }
+    *poolEnd += length;
+    return (char *)offset;
+}
+
+size_t _WriteBlob(ScmdpWorkspace *workspace, char *blob)
+{
+    ScmdpBlobHeader header;
+    ScmdpWorkspace savedWorkspace = *workspace;
+    ScmdpOptArg savedOptArg;
+    ScmdpNonOptArg savedNonOptArg;
+    ScmdpKeyRef savedKeyRef;
+    size_t workspaceOffset, optArgsOffset, nonOptArgsOffset, keyIndexOffset, hotKeysOffset, rulesOffset, ruleMasksOffset, keyPoolOffset, poolEnd;
+    size_t helpOffset, helpEnd;
+
+    /* All pointer arrays go first, the string pool takes the rest of blob */
+    workspaceOffset = _AlignBlobSize(sizeof(ScmdpBlobHeader));
+    optArgsOffset = workspaceOffset + _AlignBlobSize(sizeof(ScmdpWorkspace));
+    nonOptArgsOffset = optArgsOffset + _AlignBlobSize(sizeof(ScmdpOptArg) * workspace->numOfOptArgs);
+    keyIndexOffset = nonOptArgsOffset + _AlignBlobSize(sizeof(ScmdpNonOptArg) * workspace->numOfNonOptArgs);
+    hotKeysOffset = keyIndexOffset + _AlignBlobSize(sizeof(ScmdpKeyRef) * workspace->numOfKeys);
+    rulesOffset = hotKeysOffset + _AlignBlobSize(sizeof(ScmdpHotKey) * (workspace->hotKeysMask + 1));
+    ruleMasksOffset = rulesOffset + _AlignBlobSize(sizeof(ScmdpRule) * workspace->numOfRules);
+    keyPoolOffset = ruleMasksOffset + sizeof(unsigned long long) * workspace->numOfRules * workspace->numOfMaskWords;
+    poolEnd = keyPoolOffset + workspace->keyPoolSize;
+
+    /* Help strings and value names go after all keys, so the keys are counted first */
+    helpOffset = poolEnd;
+    _SaveBlobString(NULL, &helpOffset, workspace->completeKey);
+    _SaveBlobString(NULL, &helpOffset, workspace->helpArg.longHelpKey);
+    _SaveBlobString(NULL, &helpOffset, workspace->helpArg.shortHelpKey);
+    _SaveBlobString(NULL, &helpOffset, workspace->restArg.key);
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        _SaveBlobString(NULL, &helpOffset, workspace->optArgs[i].longKey);
+        _SaveBlobString(NULL, &helpOffset, workspace->optArgs[i].shortKey);
+    }
+    for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+    {
+        _SaveBlobString(NULL, &helpOffset, workspace->nonOptArgs[i].key);
+    }
+    helpOffset = (helpOffset + SCMDP_HELP_ALIGNMENT - 1) & ~(size_t)(SCMDP_HELP_ALIGNMENT - 1);
+    helpEnd = helpOffset;
+
+    savedWorkspace.optArgs = (ScmdpOptArg *)optArgsOffset;
+    savedWorkspace.nonOptArgs = (ScmdpNonOptArg *)nonOptArgsOffset;
+    savedWorkspace.keyIndex = (ScmdpKeyRef *)keyIndexOffset;
+    savedWorkspace.hotKeys = (ScmdpHotKey *)hotKeysOffset;
+    savedWorkspace.keyPool = (char *)keyPoolOffset;
+    savedWorkspace.rules = (ScmdpRule *)rulesOffset;
+    savedWorkspace.ruleMasks = (unsigned long long *)ruleMasksOffset;
+    /* Callbacks, bits, counters and types are bound after loading as pointers to variables */
+    savedWorkspace.optHooks = NULL;
+    savedWorkspace.flagOuts = NULL;
+    savedWorkspace.optTypes = NULL;
+    savedWorkspace.numOfFlagWords = 0;
+    savedWorkspace.flagsPlace = NULL;
+    savedWorkspace.hotCache = NULL;
+    savedWorkspace.glob = NULL;
+    savedWorkspace.jsonKeys = NULL;
+    savedWorkspace.jsonKeyOffsets = NULL;
+    savedWorkspace.overlay = NULL;
+    /* Declared constraints are not needed after compilation */
+    savedWorkspace.constraints = NULL;
+    savedWorkspace.numOfConstraints = 0;
+    savedWorkspace.syntaxHelp = _SaveBlobString(blob, &helpEnd, workspace->syntaxHelp);
+    savedWorkspace.descriptHelp = _SaveBlobString(blob, &helpEnd, workspace->descriptHelp);
+    savedWorkspace.completeKey = _SaveBlobString(blob, &poolEnd, workspace->completeKey);
+    savedWorkspace.helpArg.longHelpKey = _SaveBlobString(blob, &poolEnd, workspace->helpArg.longHelpKey);
+    savedWorkspace.helpArg.shortHelpKey = _SaveBlobString(blob, &poolEnd, workspace->helpArg.shortHelpKey);
+    savedWorkspace.restArg.key = _SaveBlobString(blob, &poolEnd, workspace->restArg.key);
+    savedWorkspace.restArg.help = _SaveBlobString(blob, &helpEnd, workspace->restArg.help);
+    savedWorkspace.restArg.valPlace = NULL;
+    savedWorkspace.restArg.countPlace = NULL;
+    savedWorkspace.blob = NULL;
+    savedWorkspace.mappedSize = 0;
+
+    for (int i = 0; i < workspace->numOfOptArgs; i++)
+    {
+        savedOptArg = workspace->optArgs[i];
+        savedOptArg.longKey = _SaveBlobString(blob, &poolEnd, savedOptArg.longKey);
+        savedOptArg.shortKey = _SaveBlobString(blob, &poolEnd, savedOptArg.shortKey);
+        savedOptArg.valName = _SaveBlobString(blob, &helpEnd, savedOptArg.valName);
+        savedOptArg.help = _SaveBlobString(blob, &helpEnd, savedOptArg.help);
+        savedOptArg.valPlace = NULL;
+        if (blob != NULL)
         {
-            printf("\n%3s%-10s", " ", workspace->nonOptArgs[i].key);
-            while (checkSymbol = *workspace->nonOptArgs[i].help++)
-            {
-                if (checkSymbol == '\n')
-                {
-                    printf("\n%-13s", " ");
-                }
-                else
-                {
-                    printf("%c", checkSymbol);
-                }
-            }
+            memcpy(blob + optArgsOffset + sizeof(ScmdpOptArg) * i, &savedOptArg, sizeof(ScmdpOptArg));
         }
-        printf("\n\n>> Optional agruments:\n");
-        for (int i = 0; i < workspace->numOfOptArgs; i++)
+    }
+    for (int i = 0; i < workspace->numOfNonOptArgs; i++)
+    {
+        savedNonOptArg = workspace->nonOptArgs[i];
+        savedNonOptArg.key = _SaveBlobString(blob, &poolEnd, savedNonOptArg.key);
+        savedNonOptArg.help = _SaveBlobString(blob, &helpEnd, savedNonOptArg.help);
+        savedNonOptArg.valPlace = NULL;
+        if (blob != NULL)
         {
-            printf("\n%3s%-10s,%-5s%-7s", " ", workspace->optArgs[i].longKey, workspace->optArgs[i].shortKey, workspace->optArgs[i].valName);
-            while (checkSymbol = *workspace->optArgs[i].help++)
-            {
-                if (checkSymbol == '\n')
-                {
-                    printf("\n%-26s", " ");
-                }
-                else
-                {
-                    printf("%c", checkSymbol);
-                }
-            }
+            memcpy(blob + nonOptArgsOffset + sizeof(ScmdpNonOptArg) * i, &savedNonOptArg, sizeof(ScmdpNonOptArg));
         }
     }
+
+    if (blob == NULL)
+    {
+        return helpEnd;
+    }
+
+    /* Indexed keys point into the key pool, the hash table keeps positions in it already */
+    for (int i = 0; i < workspace->numOfKeys; i++)
+    {
+        savedKeyRef = workspace->keyIndex[i];
+        savedKeyRef.key = (char *)(keyPoolOffset + (savedKeyRef.key - workspace->keyPool));
+        memcpy(blob + keyIndexOffset + sizeof(ScmdpKeyRef) * i, &savedKeyRef, sizeof(ScmdpKeyRef));
+    }
+    memcpy(blob + hotKeysOffset, workspace->hotKeys, sizeof(ScmdpHotKey) * (workspace->hotKeysMask + 1));
+    memcpy(blob + keyPoolOffset, workspace->keyPool, workspace->keyPoolSize);
+    memcpy(blob + rulesOffset, workspace->rules, sizeof(ScmdpRule) * workspace->numOfRules);
+    memcpy(blob + ruleMasksOffset, workspace->ruleMasks, sizeof(unsigned long long) * workspace->numOfRules * workspace->numOfMaskWords);
+    memcpy(blob + workspaceOffset, &savedWorkspace, sizeof(ScmdpWorkspace));
+
+    header.magic = SCMDP_BLOB_MAGIC;
+    header.version = SCMDP_BLOB_VERSION;
+    header.pointerSize = sizeof(void *);
+    header.size = helpEnd;
+    header.relocatedBase = 0;
+    header.checksum = _HashBytes(blob + sizeof(ScmdpBlobHeader), helpOffset - sizeof(ScmdpBlobHeader));
+    header.helpOffset = helpOffset;
+    header.helpState = 0;
+    header.helpChecksum = _HashBytes(blob + helpOffset, helpEnd - helpOffset);
+    memcpy(blob, &header, sizeof(ScmdpBlobHeader));
+    return helpEnd;
+}
+
+bool _RelocateBlobString(char **field, char *base, size_t size)
+{
+    size_t offset = (size_t)*field;
+
+    if (offset == 0)
+    {
+        return true;
+    }
+    if (offset >= size)
+    {
+        return false;
+    }
+    *field = base + offset;
+    return true;
+}
+
+#ifndef _WIN32
+size_t _AlignHelpPages(unsigned long long helpOffset, size_t size)
+{
+    unsigned long long pageSize = (unsigned long long)sysconf(_SC_PAGESIZE);
+
+    /* Pool is aligned to 4096 in the blob, larger pages begin later */
+    helpOffset = (helpOffset + pageSize - 1) & ~(pageSize - 1);
+    return (helpOffset < size) ? (size_t)helpOffset : size;
 }
+#endif
 
 void _DeleteWorkspace(ScmdpWorkspace *workspace)
 {
-    free(workspace->optArgs);
-    free(workspace->nonOptArgs);
+    /* Callbacks, bits, counters, types, JSON names and glob are made after loading, so they are allocated even for the loaded workspace */
+    free(workspace->optHooks);
+    free(workspace->flagOuts);
+    free(workspace->optTypes);
+    free(workspace->jsonKeys);
+    free(workspace->jsonKeyOffsets);
+    if (workspace->hotCache != NULL)
+    {
+        free(workspace->hotCache->totals);
+        free(workspace->hotCache);
+    }
+    workspace->optHooks = NULL;
+    workspace->flagOuts = NULL;
+    workspace->optTypes = NULL;
+    free(workspace->glob);
+    workspace->hotCache = NULL;
+    workspace->glob = NULL;
+    workspace->jsonKeys = NULL;
+    workspace->jsonKeyOffsets = NULL;
+    if (workspace->blob == NULL)
+    {
+        free(workspace->optArgs);
+        free(workspace->nonOptArgs);
+        free(workspace->keyIndex);
+        free(workspace->hotKeys);
+        free(workspace->keyPool);
+        free(workspace->constraints);
+        free(workspace->rules);
+        free(workspace->ruleMasks);
+    }
+    else if (workspace->mappedSize != 0)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(workspace->blob);
+#else
+        munmap(workspace->blob, workspace->mappedSize);
+#endif
+    }
+    workspace->blob = NULL;
+    workspace->mappedSize = 0;
+    workspace->keyIndex = NULL;
+    workspace->hotKeys = NULL;
+    workspace->keyPool = NULL;
+    workspace->constraints = NULL;
+    workspace->rules = NULL;
+    workspace->ruleMasks = NULL;
+    workspace->isCompiled = false;
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+/* Checks of test programs, a failed one prints its place and returns 1 from the calling function */
+#ifndef H_CHECK
+#define H_CHECK
+
+#include <stdio.h>
+
+#define CHECK(condition) do { if (!(condition)) { printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); return 1; } } while (0)
+
+#endif
@@ -0,0 +1,95 @@
+/* Budgets of parsing: hostile command lines are rejected at once (see SetParseBudget()) */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "check.h"
+
+/* Rejection looks at a few arguments only, the bound is far above it and far below the work on the whole line */
+#define MAX_REJECT_SECONDS 0.05
+
+#define NUM_OF_TOKENS 500000
+#define VALUE_SIZE (8 * 1024 * 1024)
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--verbose] [--level N] [FILES...]", "Test of budgets");
+    ScmdpBudget budget = {1000, 4096, 65536, 10};
+    ScmdpParseContext context;
+    char *verbose = NULL;
+    char *level = NULL;
+    char **files = NULL;
+    int numOfFiles = 0;
+    char **tokens = malloc(sizeof(char *) * (NUM_OF_TOKENS + 1));
+    char *value = malloc(VALUE_SIZE + 1);
+    double start;
+
+    AddOptArg(&workspace, "--verbose", "-v", "Verbose output", "", &verbose);
+    AddOptArg(&workspace, "--level", "-l", "Level of output", "N", &level);
+    AddRestArg(&workspace, "FILES", "Files to process", 0, -1, &files, &numOfFiles);
+    SetParseBudget(&workspace, budget);
+    context = AddParseContext(&workspace);
+
+    /* 500k tokens are over the number of tokens */
+    tokens[0] = "app";
+    for (int i = 1; i <= NUM_OF_TOKENS; i++)
+    {
+        tokens[i] = "-v";
+    }
+    start = Seconds();
+    CHECK(!ParseArgsInContext(&workspace, &context, NUM_OF_TOKENS + 1, tokens));
+    CHECK(Seconds() - start < MAX_REJECT_SECONDS);
+    CHECK(context.error.code == ERR_OVER_BUDGET);
+    CHECK(context.error.argIndex == budget.maxTokens + 1);
+
+    /* Repeated flag is stopped at the first entry over the limit */
+    start = Seconds();
+    CHECK(!ParseArgsInContext(&workspace, &context, budget.maxTokens + 1, tokens));
+    CHECK(Seconds() - start < MAX_REJECT_SECONDS);
+    CHECK(context.error.code == ERR_OVER_BUDGET);
+    CHECK(context.error.argIndex == budget.maxRepeats + 1);
+
+    /* 8 MB value is over the length of one token, only the bytes up to the limit are read */
+    memset(value, 'a', VALUE_SIZE);
+    value[VALUE_SIZE] = '\0';
+    char *longValue[] = {"app", "-l", value};
+    start = Seconds();
+    CHECK(!ParseArgsInContext(&workspace, &context, 3, longValue));
+    CHECK(Seconds() - start < MAX_REJECT_SECONDS);
+    CHECK(context.error.code == ERR_OVER_BUDGET);
+    CHECK(context.error.argIndex == 2);
+
+    /* Values under the length of token are still over the total length together */
+    value[4000] = '\0';
+    char *manyValues[32] = {"app"};
+    for (int i = 1; i < 32; i++)
+    {
+        manyValues[i] = value;
+    }
+    CHECK(!ParseArgsInContext(&workspace, &context, 32, manyValues));
+    CHECK(context.error.code == ERR_OVER_BUDGET);
+    CHECK(context.error.argIndex == 17);
+
+    /* Command line within the budget is parsed as usual */
+    char *correct[] = {"app", "-v", "-l", "3"};
+    CHECK(ParseArgsInContext(&workspace, &context, 4, correct));
+    CHECK(context.optVals[0] != NULL && strcmp(context.optVals[1], "3") == 0);
+
+    free(value);
+    free(tokens);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+    printf("budget: OK\n");
+    return 0;
+}
@@ -0,0 +1,134 @@
+/* Hot key cache: the most used keys go first, parsers keep matching right keys while it's rebuilt */
+#include <scmdp.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "check.h"
+
+#define NUM_OF_OPTS 40
+#define NUM_OF_THREADS 4
+#define NUM_OF_PARSINGS 20000
+
+static ScmdpWorkspace workspace;
+static char longKeys[NUM_OF_OPTS][16];
+static char shortKeys[NUM_OF_OPTS][16];
+static char values[NUM_OF_OPTS][16];
+static atomic_long numOfWrongParsings;
+
+/* Entered options get their numbers as values, so a wrong match is seen at once */
+static bool ParseTwo(ScmdpParseContext *context, int first, int second)
+{
+    char *argv[] = {"app", longKeys[first], values[first], shortKeys[second], values[second]};
+
+    if (!ParseArgsInContext(&workspace, context, 5, argv))
+    {
+        return false;
+    }
+    for (int i = 0; i < NUM_OF_OPTS; i++)
+    {
+        if ((i == first || i == second) ? (context->optVals[i] == NULL || atoi(context->optVals[i]) != i) : context->optVals[i] != NULL)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Id of option in the slot of cache read by parsers */
+static int CachedId(int slot)
+{
+    long long entry = workspace.hotCache->slots[workspace.hotCache->current][slot];
+
+    return (entry == 0) ? -1 : workspace.hotKeys[(entry & 0xFFFFFFFF) - 1].id;
+}
+
+static void *ParseMany(void *data)
+{
+    ScmdpParseContext context = AddParseContext(&workspace);
+    unsigned int seed = (unsigned int)(size_t)data;
+    int first, second;
+
+    /* Usage of every thread changes in the middle, so the cache is rebuilt while the others parse */
+    for (int i = 0; i < NUM_OF_PARSINGS; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        first = (i < NUM_OF_PARSINGS / 2) ? (int)(seed >> 16) % 4 : 20 + (int)(seed >> 16) % 4;
+        second = (first + 1 + (int)(seed >> 8) % (NUM_OF_OPTS - 1)) % NUM_OF_OPTS;
+        if (!ParseTwo(&context, first, second))
+        {
+            atomic_fetch_add(&numOfWrongParsings, 1);
+        }
+    }
+    DeleteParseContext(&context);
+    return NULL;
+}
+
+int main(void)
+{
+    ScmdpParseContext context;
+    pthread_t threads[NUM_OF_THREADS];
+
+    workspace = AddWorkspace("USAGE: app [--optN N]...", "Test of hot key cache");
+    for (int i = 0; i < NUM_OF_OPTS; i++)
+    {
+        snprintf(longKeys[i], sizeof(longKeys[i]), "--opt%d", i);
+        snprintf(shortKeys[i], sizeof(shortKeys[i]), "-o%d", i);
+        snprintf(values[i], sizeof(values[i]), "%d", i);
+        AddOptArg(&workspace, longKeys[i], shortKeys[i], "Option of test", "N", NULL);
+    }
+    EnableHotKeyCache(&workspace, 8);
+    context = AddParseContext(&workspace);
+
+    /* Nothing is cached before the first report */
+    CHECK(CachedId(0) == -1);
+    for (int i = 0; i < 7; i++)
+    {
+        CHECK(ParseTwo(&context, 7, 13));
+    }
+    CHECK(CachedId(0) == -1);
+
+    /* Report is made before the parsing, then both keys of every used option are cached by usage */
+    CHECK(ParseTwo(&context, 7, 30));
+    CHECK(CachedId(0) == 7 && CachedId(1) == 7);
+    CHECK(CachedId(2) == 13 && CachedId(3) == 13);
+    CHECK(CachedId(4) == -1);
+    for (int i = 0; i < 8; i++)
+    {
+        CHECK(ParseTwo(&context, 30, 13));
+    }
+    CHECK(CachedId(0) == 13 && CachedId(2) == 30 && CachedId(4) == 7);
+
+    /* Old matches weigh less after every rebuild, so the new favourite takes the first slots */
+    for (int i = 0; i < 64; i++)
+    {
+        CHECK(ParseTwo(&context, 21, 22));
+    }
+    CHECK(CachedId(0) == 21 || CachedId(0) == 22);
+    CHECK(CachedId(2) == 21 || CachedId(2) == 22);
+
+    /* Cached keys and keys out of cache are matched the same way */
+    for (int i = 0; i < NUM_OF_OPTS; i++)
+    {
+        CHECK(ParseTwo(&context, i, (i + 21) % NUM_OF_OPTS));
+    }
+    DeleteParseContext(&context);
+
+    /* Contexts of threads report and rebuild the shared cache concurrently */
+    for (int i = 0; i < NUM_OF_THREADS; i++)
+    {
+        CHECK(pthread_create(&threads[i], NULL, ParseMany, (void *)(size_t)(i + 1)) == 0);
+    }
+    for (int i = 0; i < NUM_OF_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    CHECK(atomic_load(&numOfWrongParsings) == 0);
+    CHECK(CachedId(0) >= 20 && CachedId(0) < 24);
+
+    DeleteWorkspace(&workspace);
+    printf("cache: OK\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+/* Completion mode of ParseArgs(): what the shell gets for every cursor */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "check.h"
+
+static char output[4096];
+
+/* Runs completion on a fresh workspace (ParseArgs() deletes it) and keeps what was printed in output */
+static void Complete(ScmdpSyntax syntax, int argc, char *argv[])
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--cpus LIST] [--verbose]", "Test of completion");
+    char *cpus = NULL;
+    char *verbose = NULL;
+    FILE *captured = tmpfile();
+    int savedOut = dup(STDOUT_FILENO);
+    size_t length;
+
+    SetSyntaxProfile(&workspace, syntax);
+    AddHelpArg(&workspace, "--help", "-h");
+    AddCompleteArg(&workspace, "--complete");
+    AddOptArg(&workspace, "--cpus", "-c", "CPUs to use", "LIST", &cpus);
+    AddOptArg(&workspace, "--verbose", "-v", "Verbose output", "", &verbose);
+
+    fflush(stdout);
+    dup2(fileno(captured), STDOUT_FILENO);
+    ParseArgs(&workspace, argc, argv);
+    fflush(stdout);
+    dup2(savedOut, STDOUT_FILENO);
+    close(savedOut);
+
+    rewind(captured);
+    length = fread(output, 1, sizeof(output) - 1, captured);
+    output[length] = '\0';
+    fclose(captured);
+}
+
+int main(void)
+{
+    ScmdpSyntax posix = SCMDP_SYNTAX_POSIX;
+    ScmdpSyntax folded = {"-", "=", true, true};
+
+    char *valid[] = {"app", "--complete", "0", "--c"};
+    Complete(posix, 4, valid);
+    CHECK(strcmp(output, "--cpus\n") == 0);
+
+    char *afterLast[] = {"app", "--complete", "1", "--verbose"};
+    Complete(posix, 4, afterLast);
+    CHECK(strcmp(output, "") == 0);
+
+    /* Cursors outside of the words or not numbers at all must not be used as index */
+    char *negative[] = {"app", "--complete", "-1", "--c"};
+    Complete(posix, 4, negative);
+    CHECK(strcmp(output, "") == 0);
+
+    char *tooLarge[] = {"app", "--complete", "2", "--c"};
+    Complete(posix, 4, tooLarge);
+    CHECK(strcmp(output, "") == 0);
+
+    char *huge[] = {"app", "--complete", "99999999999999999999", "--c"};
+    Complete(posix, 4, huge);
+    CHECK(strcmp(output, "") == 0);
+
+    char *partial[] = {"app", "--complete", "0x", "--c"};
+    Complete(posix, 4, partial);
+    CHECK(strcmp(output, "") == 0);
+
+    char *empty[] = {"app", "--complete", "", "--c"};
+    Complete(posix, 4, empty);
+    CHECK(strcmp(output, "") == 0);
+
+    /* Keys of any case are completed if the profile folds the case */
+    char *upperCase[] = {"app", "--complete", "0", "--CP"};
+    Complete(folded, 4, upperCase);
+    CHECK(strcmp(output, "--cpus\n") == 0);
+
+    char *allKeys[] = {"app", "--complete", "0", "-"};
+    Complete(folded, 4, allKeys);
+    CHECK(strcmp(output, "--cpus\n--help\n--verbose\n-c\n-h\n-v\n") == 0);
+
+    char *afterFlag[] = {"app", "--complete", "1", "--VERBOSE", "--H"};
+    Complete(folded, 5, afterFlag);
+    CHECK(strcmp(output, "--help\n") == 0);
+
+    Complete(posix, 4, upperCase);
+    CHECK(strcmp(output, "") == 0);
+
+    printf("completion: OK\n");
+    return 0;
+}
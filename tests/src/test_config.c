@@ -0,0 +1,164 @@
+/* Config watch: only changed options reach the handler, readers run during the reloads */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "check.h"
+
+#define NUM_OF_READERS 4
+#define NUM_OF_RELOADS 20
+
+static ScmdpConfigWatch watch;
+static atomic_int isReading;
+static atomic_long numOfWrongReads;
+static int changedIds[8];
+static int numOfChanged;
+static int numOfCalls;
+static char folder[] = "/tmp/scmdp_configXXXXXX";
+
+static void OnChange(ScmdpConfigValues *values, int *ids, int count, void *userData)
+{
+    (void)values;
+    (void)userData;
+    numOfCalls++;
+    numOfChanged = count;
+    memcpy(changedIds, ids, sizeof(int) * ((count < 8) ? count : 8));
+}
+
+/* File is replaced by renaming, so the watch never sees it half written */
+static void WriteConfig(char *name, char *text)
+{
+    char path[64];
+    char tempPath[64];
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s", folder, name);
+    snprintf(tempPath, sizeof(tempPath), "%s/.%s.tmp", folder, name);
+    file = fopen(tempPath, "w");
+    fputs(text, file);
+    fclose(file);
+    rename(tempPath, path);
+}
+
+/* Published values never change, so a reader sees both options of one publication */
+static void *ReadConfig(void *data)
+{
+    ScmdpConfigValues *values;
+    int ticket;
+
+    (void)data;
+    while (atomic_load(&isReading))
+    {
+        ticket = EnterConfig(&watch, &values);
+        if (values->optVals[0] == NULL || values->optVals[1] == NULL || atoi(values->optVals[0]) != atoi(values->optVals[1]))
+        {
+            atomic_fetch_add(&numOfWrongReads, 1);
+        }
+        LeaveConfig(&watch, ticket);
+    }
+    return NULL;
+}
+
+/* Changes are polled until some option is changed */
+static int PollChanges(void)
+{
+    int changed = 0;
+
+    for (int i = 0; i < 50 && changed == 0; i++)
+    {
+        changed = PollConfigWatch(&watch, 100);
+    }
+    return changed;
+}
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--level N] [--limit N] [--name NAME]", "Test of config watch");
+    ScmdpConfigValues *values;
+    pthread_t readers[NUM_OF_READERS];
+    char path[64];
+    char text[64];
+    char *level = NULL;
+    char *limit = NULL;
+    char *name = NULL;
+    int ticket;
+
+    AddOptArg(&workspace, "--level", "-l", "Level of output", "N", &level);
+    AddOptArg(&workspace, "--limit", "-L", "Limit of output", "N", &limit);
+    AddOptArg(&workspace, "--name", "-n", "Name of output", "NAME", &name);
+    CHECK(mkdtemp(folder) != NULL);
+    WriteConfig("base.conf", "--level 1 --limit 1\n--name blue\n");
+    WriteConfig("local.conf", "# Local values override the base ones\n--level 2 --limit 2\n");
+
+    /* Later file overrides the earlier one */
+    watch = AddConfigWatch(&workspace, OnChange, NULL);
+    snprintf(path, sizeof(path), "%s/base.conf", folder);
+    CHECK(AddConfigFile(&watch, path));
+    snprintf(path, sizeof(path), "%s/local.conf", folder);
+    CHECK(AddConfigFile(&watch, path));
+    ticket = EnterConfig(&watch, &values);
+    CHECK(strcmp(values->optVals[0], "2") == 0 && strcmp(values->optVals[2], "blue") == 0);
+    LeaveConfig(&watch, ticket);
+
+    /* Handler gets only the changed option */
+    numOfCalls = 0;
+    WriteConfig("base.conf", "--level 1 --limit 1\n--name red\n");
+    CHECK(PollChanges() == 1);
+    CHECK(numOfCalls == 1 && numOfChanged == 1 && changedIds[0] == 2);
+    ticket = EnterConfig(&watch, &values);
+    CHECK(strcmp(values->optVals[0], "2") == 0 && strcmp(values->optVals[2], "red") == 0);
+    LeaveConfig(&watch, ticket);
+
+    /* Overridden option of base file is read, but it's not changed */
+    WriteConfig("base.conf", "--level 7 --limit 1\n--name red\n");
+    CHECK(PollConfigWatch(&watch, 1000) == 0);
+    CHECK(strcmp(watch.files[0].optVals[0], "7") == 0);
+    CHECK(numOfCalls == 1);
+
+    /* File with errors keeps its previous values */
+    WriteConfig("local.conf", "--level 5 --unknown\n");
+    CHECK(PollConfigWatch(&watch, 1000) == 0);
+    CHECK(watch.error.code == ERR_UNKNOWN_PARAMETER);
+    CHECK(strcmp(watch.files[1].optVals[0], "2") == 0);
+    ticket = EnterConfig(&watch, &values);
+    CHECK(strcmp(values->optVals[0], "2") == 0);
+    LeaveConfig(&watch, ticket);
+
+    /* Readers never wait and never see freed or half published values while the config is reloaded */
+    atomic_store(&isReading, 1);
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        CHECK(pthread_create(&readers[i], NULL, ReadConfig, NULL) == 0);
+    }
+    for (int i = 3; i < 3 + NUM_OF_RELOADS; i++)
+    {
+        snprintf(text, sizeof(text), "--level %d --limit %d\n", i, i);
+        WriteConfig("local.conf", text);
+        CHECK(PollChanges() == 2);
+        CHECK(numOfChanged == 2 && changedIds[0] == 0 && changedIds[1] == 1);
+    }
+    atomic_store(&isReading, 0);
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+    CHECK(atomic_load(&numOfWrongReads) == 0);
+    ticket = EnterConfig(&watch, &values);
+    CHECK(atoi(values->optVals[0]) == 2 + NUM_OF_RELOADS);
+    LeaveConfig(&watch, ticket);
+
+    DeleteConfigWatch(&watch);
+    DeleteWorkspace(&workspace);
+    snprintf(path, sizeof(path), "%s/base.conf", folder);
+    remove(path);
+    snprintf(path, sizeof(path), "%s/local.conf", folder);
+    remove(path);
+    remove(folder);
+    printf("config: OK\n");
+    return 0;
+}
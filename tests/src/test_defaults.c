@@ -0,0 +1,63 @@
+/* Defaults of typed optional arguments are converted like entered values */
+#include <scmdp.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+
+static char *ProvideDefault(int optId, void *userData)
+{
+    (void)optId;
+    return userData;
+}
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--cpus LIST] [--cache SIZE] [--timeout TIME]", "Test of typed defaults");
+    ScmdpParseContext context;
+    char *cpus = NULL;
+    char *cache = NULL;
+    char *timeout = NULL;
+    ScmdpNumbers cpuList;
+    long long cacheSize = 0;
+    int cpusId, cacheId, timeoutId;
+
+    cpusId = AddOptArg(&workspace, "--cpus", "-c", "CPUs to use", "LIST", &cpus);
+    cacheId = AddOptArg(&workspace, "--cache", "-s", "Size of cache", "SIZE", &cache);
+    timeoutId = AddOptArg(&workspace, "--timeout", "-t", "Timeout", "TIME", &timeout);
+    SetOptType(&workspace, cpusId, SCMDP_TYPE_INT_LIST, &cpuList);
+    SetOptType(&workspace, cacheId, SCMDP_TYPE_SIZE, &cacheSize);
+    SetOptType(&workspace, timeoutId, SCMDP_TYPE_DURATION, NULL);
+    SetOptDefault(&workspace, cpusId, ProvideDefault, "0-3,8");
+    SetOptDefault(&workspace, cacheId, ProvideDefault, "4K");
+    context = AddParseContext(&workspace);
+
+    /* Entered values and defaults share the arena, all of them point into it after parsing */
+    char *timeoutOnly[] = {"app", "-t", "1s"};
+    CHECK(ParseArgsInContext(&workspace, &context, 3, timeoutOnly));
+    CHECK(context.typedVals[timeoutId].count == 1 && context.typedVals[timeoutId].values[0] == 1000000000LL);
+    CHECK(context.typedVals[cpusId].count == 5 && context.typedVals[cpusId].values[4] == 8);
+    CHECK(context.typedVals[cacheId].count == 1 && context.typedVals[cacheId].values[0] == 4096);
+    CHECK(cpuList.count == 5 && cpuList.values[3] == 3);
+    CHECK(cacheSize == 4096);
+
+    char *entered[] = {"app", "-c", "7", "-s", "1M"};
+    CHECK(ParseArgsInContext(&workspace, &context, 5, entered));
+    CHECK(context.typedVals[cpusId].count == 1 && context.typedVals[cpusId].values[0] == 7);
+    CHECK(context.typedVals[cacheId].values[0] == 1048576);
+    CHECK(context.typedVals[timeoutId].count == 0);
+
+    DeleteParseContext(&context);
+
+    /* Wrong default fails like a wrong entered value */
+    SetOptDefault(&workspace, cacheId, ProvideDefault, "lots");
+    context = AddParseContext(&workspace);
+    char *nothing[] = {"app"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 1, nothing));
+    CHECK(context.error.code == ERR_WRONG_NUMBER && context.error.optId == cacheId);
+
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+    printf("defaults: OK\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+/* Flags and counters: repeated short keys, the limit of count and the bound bitset of flags */
+#include <scmdp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [-v] [-q] [-x] [--name NAME]", "Test of flags");
+    ScmdpParseContext context;
+    char *verbose = NULL;
+    char *quiet = NULL;
+    char *extra = NULL;
+    char *name = NULL;
+    int verboseCount = -1;
+    unsigned long long flags[2] = {0, 0};
+    int verboseId, quietId, extraId;
+
+    verboseId = AddOptArg(&workspace, "--verbose", "-v", "Verbose output, may be repeated", "", &verbose);
+    quietId = AddOptArg(&workspace, "--quiet", "-q", "Quiet output", "", &quiet);
+    extraId = AddOptArg(&workspace, "--extra", "-x", "Extra checks", "", &extra);
+    AddOptArg(&workspace, "--name", "-n", "Name of output", "NAME", &name);
+    CHECK(SetOptCounter(&workspace, verboseId, &verboseCount));
+    CHECK(SetOptFlag(&workspace, quietId, 0));
+    CHECK(SetOptFlag(&workspace, extraId, 70));
+    CHECK(!SetOptCounter(&workspace, 3, NULL));
+    CHECK(!SetOptFlag(&workspace, 3, 1));
+    BindFlagsPlace(&workspace, flags);
+    context = AddParseContext(&workspace);
+
+    /* Run of the last character of short key counts as many entries */
+    char *run[] = {"app", "-vvv"};
+    CHECK(ParseArgsInContext(&workspace, &context, 2, run));
+    CHECK(verboseCount == 3 && context.optCounts[verboseId] == 3);
+    CHECK(verbose != NULL);
+
+    /* Runs, short and long keys are summed */
+    char *mixed[] = {"app", "-v", "-vv", "--verbose"};
+    CHECK(ParseArgsInContext(&workspace, &context, 4, mixed));
+    CHECK(verboseCount == 4);
+
+    /* Only counters are matched by runs, and the run must repeat the last character */
+    char *notCounter[] = {"app", "-qqq"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 2, notCounter));
+    CHECK(context.error.code == ERR_UNKNOWN_PARAMETER);
+    char *notRun[] = {"app", "-vvq"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 2, notRun));
+    CHECK(context.error.code == ERR_UNKNOWN_PARAMETER);
+
+    /* Count stops at 255, it's kept in one byte */
+    char *longRun = malloc(302);
+    longRun[0] = '-';
+    memset(longRun + 1, 'v', 300);
+    longRun[301] = '\0';
+    char *saturated[] = {"app", longRun, "-vvvvv"};
+    CHECK(ParseArgsInContext(&workspace, &context, 3, saturated));
+    CHECK(verboseCount == 255 && context.optCounts[verboseId] == 255);
+    free(longRun);
+
+    /* Bitset of context is copied to the bound place, absent flags are cleared */
+    char *bothFlags[] = {"app", "-q", "--extra"};
+    CHECK(ParseArgsInContext(&workspace, &context, 3, bothFlags));
+    CHECK(flags[0] == 1ULL && flags[1] == 1ULL << 6);
+    CHECK(verboseCount == 0);
+    char *oneFlag[] = {"app", "-x", "--name", "out"};
+    CHECK(ParseArgsInContext(&workspace, &context, 4, oneFlag));
+    CHECK(flags[0] == 0 && flags[1] == 1ULL << 6);
+    CHECK(strcmp(name, "out") == 0);
+
+    /* Failed parsing leaves the bound bitset as it was */
+    char *wrong[] = {"app", "-q", "--unknown"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 3, wrong));
+    CHECK(flags[0] == 0 && flags[1] == 1ULL << 6);
+
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+    printf("flags: OK\n");
+    return 0;
+}
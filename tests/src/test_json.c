@@ -0,0 +1,81 @@
+/* JSON names of FormatParseResult(): loaded workspaces, overlays and concurrent formatting */
+#include <scmdp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "check.h"
+
+static ScmdpWorkspace loaded;
+static ScmdpParseContext loadedContext;
+
+/* Every thread formats the same result, the first calls build the names at the same time */
+static void *Format(void *output)
+{
+    FormatParseResult(&loaded, &loadedContext, output, 256, SCMDP_FORMAT_JSON);
+    return NULL;
+}
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--level N] [--dry-run] FILE", "Test of JSON");
+    ScmdpParseContext context;
+    ScmdpOverlay overlay;
+    char *level = NULL;
+    char *dryRun = NULL;
+    char *file = NULL;
+    char *tenant = NULL;
+    char json[256];
+    char outputs[4][256];
+    pthread_t threads[4];
+    void *blob;
+    size_t size;
+
+    AddOptArg(&workspace, "--level", "-l", "Level of output", "N", &level);
+    AddOptArg(&workspace, "--dry-run", "-n", "Nothing is changed", "", &dryRun);
+    AddNonOptArg(&workspace, "FILE", "File to process", &file);
+    char *args[] = {"app", "-l", "3", "-n", "in.txt"};
+
+    context = AddParseContext(&workspace);
+    CHECK(ParseArgsInContext(&workspace, &context, 5, args));
+    FormatParseResult(&workspace, &context, json, sizeof(json), SCMDP_FORMAT_JSON);
+    CHECK(strcmp(json, "{\"FILE\":\"in.txt\",\"level\":\"3\",\"dry-run\":true}") == 0);
+
+    /* Loaded workspace has no names until the first formatting */
+    size = SaveWorkspace(&workspace, NULL, 0);
+    blob = aligned_alloc(64, (size + 63) / 64 * 64);
+    CHECK(SaveWorkspace(&workspace, blob, size) == size);
+    CHECK(LoadWorkspace(&loaded, blob, size));
+    CHECK(loaded.jsonKeys == NULL);
+    loadedContext = AddParseContext(&loaded);
+    CHECK(ParseArgsInContext(&loaded, &loadedContext, 5, args));
+    for (int i = 0; i < 4; i++)
+    {
+        pthread_create(&threads[i], NULL, Format, outputs[i]);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        pthread_join(threads[i], NULL);
+        CHECK(strcmp(outputs[i], json) == 0);
+    }
+
+    /* View of overlay shares the names of base, added options have their own */
+    overlay = AddOverlay(&workspace);
+    AddOverlayOptArg(&overlay, "--tenant", "-t", "Tenant name", "NAME", &tenant);
+    ScmdpParseContext overlayContext = AddOverlayContext(&overlay);
+    char *overlayArgs[] = {"app", "--tenant", "blue", "-l", "1", "in.txt"};
+    CHECK(ParseArgsInOverlay(&overlay, &overlayContext, 6, overlayArgs));
+    FormatParseResult(&overlay.view, &overlayContext, json, sizeof(json), SCMDP_FORMAT_JSON);
+    CHECK(strcmp(json, "{\"FILE\":\"in.txt\",\"level\":\"1\",\"tenant\":\"blue\"}") == 0);
+
+    DeleteParseContext(&overlayContext);
+    DeleteOverlay(&overlay);
+    DeleteParseContext(&loadedContext);
+    DeleteWorkspace(&loaded);
+    free(blob);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+    printf("json: OK\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+/* Repeated keys: the workspace is not compiled and parsing fails without printing anything */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "check.h"
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--level N] [--limit N]", "Test of repeated keys");
+    ScmdpParseContext context;
+    char *level = NULL;
+    char *limit = NULL;
+    FILE *captured = tmpfile();
+    int savedOut = dup(STDOUT_FILENO);
+    long printed;
+
+    AddHelpArg(&workspace, "--help", "-h");
+    AddOptArg(&workspace, "--level", "-l", "Level of output", "N", &level);
+    AddOptArg(&workspace, "--limit", "-l", "Limit of output", "N", &limit);
+
+    /* Error is reported by the context, parsing is refused with the same error and prints nothing */
+    fflush(stdout);
+    dup2(fileno(captured), STDOUT_FILENO);
+    context = AddParseContext(&workspace);
+    char *args[] = {"app", "-l", "1"};
+    bool isParsed = ParseArgsInContext(&workspace, &context, 3, args);
+    fflush(stdout);
+    dup2(savedOut, STDOUT_FILENO);
+    printed = ftell(captured);
+    fclose(captured);
+
+    CHECK(printed == 0);
+    CHECK(!isParsed);
+    CHECK(context.error.code == ERR_REPEATED_KEY);
+    CHECK(context.error.optId == 1 && context.error.otherOptId == 0);
+    CHECK(level == NULL && limit == NULL);
+    CHECK(SaveWorkspace(&workspace, NULL, 0) == 0);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+
+    /* Key of help argument can't be repeated either */
+    ScmdpWorkspace helpWorkspace = AddWorkspace("USAGE: app [--host NAME]", "Test of repeated keys");
+    char *host = NULL;
+
+    AddHelpArg(&helpWorkspace, "--help", "-h");
+    AddOptArg(&helpWorkspace, "--host", "-h", "Name of host", "NAME", &host);
+    context = AddParseContext(&helpWorkspace);
+    CHECK(context.error.code == ERR_REPEATED_KEY);
+    CHECK(context.error.optId == 0 && context.error.otherOptId == SCMDP_HELP_ID);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&helpWorkspace);
+
+    /* Equal long and short keys of one option are not a repeat */
+    ScmdpWorkspace sameWorkspace = AddWorkspace("USAGE: app [-v]", "Test of repeated keys");
+    char *verbose = NULL;
+
+    AddOptArg(&sameWorkspace, "-v", "-v", "Verbose output", "", &verbose);
+    context = AddParseContext(&sameWorkspace);
+    CHECK(context.error.code == ERR_NONE);
+    char *flag[] = {"app", "-v"};
+    CHECK(ParseArgsInContext(&sameWorkspace, &context, 2, flag));
+    DeleteParseContext(&context);
+    DeleteWorkspace(&sameWorkspace);
+
+    /* Unknown key of constraint fails the compilation with the known option of it */
+    ScmdpWorkspace constraintWorkspace = AddWorkspace("USAGE: app [--format NAME]", "Test of unknown keys");
+    char *format = NULL;
+    char *outputKeys[] = {"--output"};
+
+    AddOptArg(&constraintWorkspace, "--format", "-f", "Format of output", "NAME", &format);
+    AddConstraint(&constraintWorkspace, SCMDP_REQUIRES, "--format", outputKeys, 1);
+    captured = tmpfile();
+    fflush(stdout);
+    dup2(fileno(captured), STDOUT_FILENO);
+    context = AddParseContext(&constraintWorkspace);
+    fflush(stdout);
+    dup2(savedOut, STDOUT_FILENO);
+    printed = ftell(captured);
+    fclose(captured);
+
+    CHECK(printed == 0);
+    CHECK(context.error.code == ERR_UNKNOWN_CONSTRAINT_KEY);
+    CHECK(context.error.optId == 0 && context.error.otherOptId == -1);
+    char *formatArgs[] = {"app", "--format", "json"};
+    CHECK(!ParseArgsInContext(&constraintWorkspace, &context, 3, formatArgs));
+    CHECK(context.error.code == ERR_UNKNOWN_CONSTRAINT_KEY && format == NULL);
+    CHECK(SaveWorkspace(&constraintWorkspace, NULL, 0) == 0);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&constraintWorkspace);
+
+    /* Key longer than 16 bits of length fails the compilation */
+    ScmdpWorkspace longWorkspace = AddWorkspace("USAGE: app [-n NAME]", "Test of long keys");
+    char *name = NULL;
+    char *longKey = malloc(0x10002);
+
+    memset(longKey, 'n', 0x10001);
+    longKey[0] = '-';
+    longKey[1] = '-';
+    longKey[0x10001] = '\0';
+    AddOptArg(&longWorkspace, longKey, "-n", "Name of output", "NAME", &name);
+    context = AddParseContext(&longWorkspace);
+    CHECK(context.error.code == ERR_TOO_LONG_KEY);
+    CHECK(context.error.optId == 0 && context.error.otherOptId == -1);
+    char *nameArgs[] = {"app", "-n", "out"};
+    CHECK(!ParseArgsInContext(&longWorkspace, &context, 3, nameArgs));
+    CHECK(context.error.code == ERR_TOO_LONG_KEY && name == NULL);
+    DeleteParseContext(&context);
+    DeleteWorkspace(&longWorkspace);
+    free(longKey);
+
+    printf("keys: OK\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+/* Command logs: columns of sharded parsing don't depend on the number of threads */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "check.h"
+
+#define NUM_OF_LINES 10007
+
+static char logPath[] = "/tmp/scmdp_logXXXXXX";
+static char columnsPath[64];
+
+/* Every line has a kind by its number, so its expected columns are known */
+static char *lines[] = {"app -v --level 3 in.txt", "app -vvv in.txt", "", "app --unknown in.txt", "app --help", "app --verbose -v in.txt\r"};
+static signed char statuses[] = {ERR_NONE, ERR_NONE, SCMDP_STATUS_EMPTY, ERR_UNKNOWN_PARAMETER, SCMDP_STATUS_HELP, ERR_NONE};
+static unsigned char verboseCounts[] = {1, 3, 0, 0, 0, 2};
+static unsigned char levelCounts[] = {1, 0, 0, 0, 0, 0};
+
+static int CheckColumns(int numOfThreads, int numOfLines)
+{
+    ScmdpColumns columns;
+    unsigned char *verbose;
+    unsigned char *level;
+    int kind;
+
+    CHECK(LoadColumnsFile(&columns, columnsPath));
+    CHECK(columns.header->numOfRows == (unsigned long long)numOfLines);
+    CHECK(columns.header->numOfOptArgs == 2);
+    verbose = GetOptColumn(&columns, 0);
+    level = GetOptColumn(&columns, 1);
+    CHECK(verbose != NULL && level != NULL && GetOptColumn(&columns, 2) == NULL);
+    for (int i = 0; i < numOfLines; i++)
+    {
+        kind = i % 6;
+        if (columns.status[i] != statuses[kind] || verbose[i] != verboseCounts[kind] || level[i] != levelCounts[kind])
+        {
+            printf("FAILED line %d of %d threads\n", i, numOfThreads);
+            return 1;
+        }
+    }
+    DeleteColumns(&columns);
+    return 0;
+}
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [-v] [--level N] FILE", "Test of command logs");
+    char *verbose = NULL;
+    char *level = NULL;
+    char *file = NULL;
+    FILE *log;
+    int fd;
+
+    AddHelpArg(&workspace, "--help", "-h");
+    SetOptCounter(&workspace, AddOptArg(&workspace, "--verbose", "-v", "Verbose output", "", &verbose), NULL);
+    AddOptArg(&workspace, "--level", "-l", "Level of output", "N", &level);
+    AddNonOptArg(&workspace, "FILE", "File to process", &file);
+
+    /* The last line has no line break */
+    fd = mkstemp(logPath);
+    CHECK(fd >= 0);
+    log = fdopen(fd, "w");
+    for (int i = 0; i < NUM_OF_LINES; i++)
+    {
+        fprintf(log, (i + 1 < NUM_OF_LINES) ? "%s\n" : "%s", lines[i % 6]);
+    }
+    fclose(log);
+    snprintf(columnsPath, sizeof(columnsPath), "%s.cols", logPath);
+
+    /* Shards are cut at line ends wherever they fall */
+    for (int numOfThreads = 1; numOfThreads <= 8; numOfThreads++)
+    {
+        CHECK(ParseLogFile(&workspace, logPath, columnsPath, numOfThreads) == NUM_OF_LINES);
+        if (CheckColumns(numOfThreads, NUM_OF_LINES) != 0)
+        {
+            return 1;
+        }
+    }
+    CHECK(verbose == NULL && level == NULL && file == NULL);
+
+    /* More threads than lines */
+    log = fopen(logPath, "w");
+    fprintf(log, "%s\n%s\n", lines[0], lines[1]);
+    fclose(log);
+    CHECK(ParseLogFile(&workspace, logPath, columnsPath, 16) == 2);
+    if (CheckColumns(16, 2) != 0)
+    {
+        return 1;
+    }
+
+    CHECK(ParseLogFile(&workspace, "/nonexistent/scmdp.log", columnsPath, 4) == -1);
+    remove(logPath);
+    remove(columnsPath);
+    DeleteWorkspace(&workspace);
+    printf("logs: OK\n");
+    return 0;
+}
@@ -0,0 +1,43 @@
+/* Boundaries of integer lists and ranges (SCMDP_TYPE_INT_LIST) */
+#include <scmdp.h>
+#include <stdio.h>
+
+#include "check.h"
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [--cpus LIST]", "Test of number lists");
+    ScmdpSyntax syntax = SCMDP_SYNTAX_POSIX;
+    ScmdpParseContext context;
+    char *cpus = NULL;
+    int cpusId;
+
+    cpusId = AddOptArg(&workspace, "--cpus", "-c", "CPUs to use", "LIST", &cpus);
+    SetSyntaxProfile(&workspace, syntax);
+    SetOptType(&workspace, cpusId, SCMDP_TYPE_INT_LIST, NULL);
+    context = AddParseContext(&workspace);
+
+    /* The widest range has 2^64 numbers, the count of them must not wrap to 0 */
+    char *widest[] = {"app", "--cpus=-9223372036854775808-9223372036854775807"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 2, widest));
+    CHECK(context.error.code == ERR_WRONG_NUMBER);
+
+    /* The largest list fits the arena exactly, one more number doesn't */
+    char *largest[] = {"app", "--cpus=0-1048575"};
+    CHECK(ParseArgsInContext(&workspace, &context, 2, largest));
+    CHECK(context.typedVals[cpusId].count == SCMDP_MAX_NUMBERS);
+    CHECK(context.typedVals[cpusId].values[SCMDP_MAX_NUMBERS - 1] == 1048575);
+
+    char *overLimit[] = {"app", "--cpus=0-1048576"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 2, overLimit));
+    CHECK(context.error.code == ERR_WRONG_NUMBER);
+
+    char *single[] = {"app", "--cpus=9223372036854775807"};
+    CHECK(ParseArgsInContext(&workspace, &context, 2, single));
+    CHECK(context.typedVals[cpusId].count == 1);
+
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+    printf("numbers: OK\n");
+    return 0;
+}
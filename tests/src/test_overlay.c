@@ -0,0 +1,111 @@
+/* Overlays: added and hidden options over a shared base workspace */
+#include <scmdp.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+
+static int numOfBaseDefaults = 0;
+
+static char *ProvideBaseDefault(int optId, void *userData)
+{
+    (void)optId;
+    numOfBaseDefaults++;
+    return userData;
+}
+
+static char *ProvideDefault(int optId, void *userData)
+{
+    (void)optId;
+    return userData;
+}
+
+int main(void)
+{
+    ScmdpWorkspace base = AddWorkspace("USAGE: app [--level N] FILE", "Test of overlays");
+    ScmdpOverlay overlay;
+    ScmdpParseContext context;
+    char *level = NULL;
+    char *file = NULL;
+    char *fast = NULL;
+    char *tenant = NULL;
+    int fastId, tenantId;
+
+    AddOptArg(&base, "--level", "-l", "Level of output", "N", &level);
+    AddNonOptArg(&base, "FILE", "File to process", &file);
+    overlay = AddOverlay(&base);
+    fastId = AddOverlayOptArg(&overlay, "--fast", "-f", "Fast mode", "", &fast);
+    tenantId = AddOverlayOptArg(&overlay, "--tenant", "-t", "Tenant name", "NAME", &tenant);
+    context = AddOverlayContext(&overlay);
+
+    /* Only the values of valuable added options are counted, so the longest command line has 6 arguments */
+    CHECK(overlay.view.numOfValOptArgs == 2);
+    char *longest[] = {"app", "--fast", "--tenant", "blue", "--level", "1", "in.txt"};
+    CHECK(ParseArgsInOverlay(&overlay, &context, 7, longest));
+    CHECK(context.optVals[fastId] != NULL && strcmp(context.optVals[tenantId], "blue") == 0);
+
+    char *tooLong[] = {"app", "--fast", "--fast", "--tenant", "blue", "--level", "1", "in.txt"};
+    CHECK(!ParseArgsInOverlay(&overlay, &context, 8, tooLong));
+    CHECK(context.error.code == ERR_WRONG_PARS_NUMBER);
+
+    DeleteParseContext(&context);
+    DeleteOverlay(&overlay);
+
+    /* Option hidden twice before the view is built is kept once */
+    overlay = AddOverlay(&base);
+    CHECK(HideOverlayOptArg(&overlay, 0));
+    CHECK(HideOverlayOptArg(&overlay, 0));
+    CHECK(overlay.numOfHidden == 1);
+    CHECK(!HideOverlayOptArg(&overlay, 1));
+    context = AddOverlayContext(&overlay);
+    CHECK(HideOverlayOptArg(&overlay, 0));
+    CHECK(overlay.numOfHidden == 1);
+    char *hidden[] = {"app", "--level", "1", "in.txt"};
+    CHECK(!ParseArgsInOverlay(&overlay, &context, 4, hidden));
+    CHECK(context.error.code == ERR_UNKNOWN_PARAMETER);
+
+    DeleteParseContext(&context);
+    DeleteOverlay(&overlay);
+    DeleteWorkspace(&base);
+
+    /* Typed defaults of overlay are converted and replace the defaults of base, hidden typed options get nothing */
+    ScmdpWorkspace typed = AddWorkspace("USAGE: app [--size SIZE] [--limit SIZE]", "Test of typed overlays");
+    char *size = NULL;
+    char *limit = NULL;
+    long long sizeBytes = -1;
+    long long limitBytes = -1;
+    int sizeId = AddOptArg(&typed, "--size", "-s", "Size of block", "SIZE", &size);
+    int limitId = AddOptArg(&typed, "--limit", "-L", "Limit of memory", "SIZE", &limit);
+
+    SetOptType(&typed, sizeId, SCMDP_TYPE_SIZE, &sizeBytes);
+    SetOptType(&typed, limitId, SCMDP_TYPE_SIZE, &limitBytes);
+    SetOptDefault(&typed, sizeId, ProvideBaseDefault, "1KiB");
+    SetOptDefault(&typed, limitId, ProvideBaseDefault, "5KiB");
+    overlay = AddOverlay(&typed);
+    CHECK(SetOverlayDefault(&overlay, sizeId, ProvideDefault, "2KiB"));
+    CHECK(HideOverlayOptArg(&overlay, limitId));
+    context = AddOverlayContext(&overlay);
+    char *noArgs[] = {"app"};
+    CHECK(ParseArgsInOverlay(&overlay, &context, 1, noArgs));
+    CHECK(numOfBaseDefaults == 0);
+    CHECK(sizeBytes == 2048 && strcmp(size, "2KiB") == 0);
+    CHECK(context.optVals[limitId] == NULL && context.typedVals[limitId].count == 0);
+    CHECK(limitBytes == -1 && limit == NULL);
+
+    char *entered[] = {"app", "--size", "3KiB"};
+    CHECK(ParseArgsInOverlay(&overlay, &context, 3, entered));
+    CHECK(sizeBytes == 3072 && limitBytes == -1);
+
+    /* Without overlay the defaults of base are used */
+    DeleteParseContext(&context);
+    context = AddParseContext(&typed);
+    CHECK(ParseArgsInContext(&typed, &context, 1, noArgs));
+    CHECK(numOfBaseDefaults == 2);
+    CHECK(sizeBytes == 1024 && limitBytes == 5120);
+
+    DeleteParseContext(&context);
+    DeleteOverlay(&overlay);
+    DeleteWorkspace(&typed);
+    printf("overlay: OK\n");
+    return 0;
+}
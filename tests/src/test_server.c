@@ -0,0 +1,135 @@
+/* Server: lines of a socket are handled by workers, counted in metrics and stopped by a handler */
+#define _POSIX_C_SOURCE 200809L
+#include <scmdp.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "check.h"
+
+static atomic_long sum;
+
+static bool AddValue(ScmdpWorkspace *workspace, ScmdpParseContext *context, void *userData)
+{
+    (void)workspace;
+    (void)userData;
+    atomic_fetch_add(&sum, atol(context->optVals[0]));
+    return true;
+}
+
+static bool Stop(ScmdpWorkspace *workspace, ScmdpParseContext *context, void *userData)
+{
+    (void)workspace;
+    (void)context;
+    (void)userData;
+    return false;
+}
+
+/* Lines are collected and written at once, a socket keeps much less of small writes */
+static char input[32768];
+static size_t inputLength = 0;
+
+static void AddLine(char *line)
+{
+    size_t length = strlen(line);
+
+    memcpy(input + inputLength, line, length);
+    input[inputLength + length] = '\n';
+    inputLength += length + 1;
+}
+
+static bool WriteLines(int fd)
+{
+    bool isWritten = (write(fd, input, inputLength) == (ssize_t)inputLength);
+
+    inputLength = 0;
+    close(fd);
+    return isWritten;
+}
+
+int main(void)
+{
+    ScmdpWorkspace add = AddWorkspace("USAGE: add --value N", "Test of server");
+    ScmdpWorkspace stop = AddWorkspace("USAGE: stop", "Test of server");
+    ScmdpConsole console;
+    ScmdpServer server;
+    ScmdpServerMetrics metrics;
+    char *value = NULL;
+    char *longLine = malloc(SCMDP_LINE_SIZE * 2);
+    FILE *captured = tmpfile();
+    int savedOut = dup(STDOUT_FILENO);
+    int fds[2];
+    long printed;
+    bool isRun;
+
+    AddOptArg(&add, "--value", "-v", "Value to add", "N", &value);
+    memset(longLine, 'a', SCMDP_LINE_SIZE * 2 - 1);
+    longLine[SCMDP_LINE_SIZE * 2 - 1] = '\0';
+
+    /* Handled lines, unknown command, wrong arguments and too long line are counted, nothing is printed */
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    for (int i = 1; i <= 100; i++)
+    {
+        AddLine("add --value 2");
+    }
+    AddLine("unknown --value 1");
+    AddLine("add --wrong 1");
+    AddLine(longLine);
+    AddLine("add -v 5");
+    CHECK(WriteLines(fds[0]));
+
+    console = AddConsole(fds[1], NULL);
+    AddConsoleCommand(&console, "add", &add, AddValue, NULL);
+    server = AddServer(&console, 4, 8);
+    fflush(stdout);
+    dup2(fileno(captured), STDOUT_FILENO);
+    isRun = RunServer(&server);
+    fflush(stdout);
+    dup2(savedOut, STDOUT_FILENO);
+    printed = ftell(captured);
+    fclose(captured);
+
+    CHECK(isRun);
+    CHECK(printed == 0);
+    metrics = GetServerMetrics(&server);
+    CHECK(metrics.numOfHandled == 101);
+    CHECK(metrics.numOfFailed == 3);
+    CHECK(metrics.queueDepth == 0);
+    CHECK(atomic_load(&sum) == 205);
+    CHECK(value == NULL);
+    DeleteServer(&server);
+    DeleteConsole(&console);
+    close(fds[1]);
+
+    /* Handler returning FALSE stops the server before the rest of lines */
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    AddLine("stop");
+    for (int i = 0; i < 1000; i++)
+    {
+        AddLine("add --value 1");
+    }
+    CHECK(WriteLines(fds[0]));
+
+    atomic_store(&sum, 0);
+    console = AddConsole(fds[1], NULL);
+    AddConsoleCommand(&console, "add", &add, AddValue, NULL);
+    AddConsoleCommand(&console, "stop", &stop, Stop, NULL);
+    server = AddServer(&console, 1, 2);
+    CHECK(RunServer(&server));
+    metrics = GetServerMetrics(&server);
+    CHECK(metrics.numOfFailed == 1);
+    CHECK(metrics.numOfHandled < 1000);
+    CHECK(metrics.numOfHandled == atomic_load(&sum));
+    DeleteServer(&server);
+    DeleteConsole(&console);
+    close(fds[1]);
+
+    free(longLine);
+    DeleteWorkspace(&add);
+    DeleteWorkspace(&stop);
+    printf("server: OK\n");
+    return 0;
+}
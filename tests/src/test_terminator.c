@@ -0,0 +1,83 @@
+/* Arguments around the '--' terminator */
+#include <scmdp.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+
+int main(void)
+{
+    ScmdpWorkspace workspace = AddWorkspace("USAGE: app [-c N] [FILES...]", "Test of terminator");
+    ScmdpParseContext context;
+    char *count = NULL;
+    char **files = NULL;
+    int numOfFiles = 0;
+
+    AddHelpArg(&workspace, "--help", "-h");
+    AddOptArg(&workspace, "--count", "-c", "Count of runs", "N", &count);
+    AddRestArg(&workspace, "FILES", "Files to process", 0, -1, &files, &numOfFiles);
+    context = AddParseContext(&workspace);
+
+    /* Help key after '--' is a value */
+    char *helpAfter[] = {"app", "--", "-h"};
+    CHECK(ParseArgsInContext(&workspace, &context, 3, helpAfter));
+    CHECK(!context.isHelpCalled);
+    CHECK(context.numOfRestVals == 1 && strcmp(context.restVals[0], "-h") == 0);
+
+    char *helpBefore[] = {"app", "-h", "--", "x"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 4, helpBefore));
+    CHECK(context.isHelpCalled);
+
+    /* Options after '--' are values too */
+    char *optionAfter[] = {"app", "-c", "1", "--", "-c", "--count"};
+    CHECK(ParseArgsInContext(&workspace, &context, 6, optionAfter));
+    CHECK(strcmp(context.optVals[0], "1") == 0);
+    CHECK(context.numOfRestVals == 2 && strcmp(context.restVals[1], "--count") == 0);
+
+    /* Values before '--' join the values after it, options stand before or after them like without '--' */
+    char *valuesBefore[] = {"app", "a", "b", "--", "-x"};
+    CHECK(ParseArgsInContext(&workspace, &context, 5, valuesBefore));
+    CHECK(context.numOfRestVals == 3);
+    CHECK(strcmp(context.restVals[0], "a") == 0 && strcmp(context.restVals[1], "b") == 0 && strcmp(context.restVals[2], "-x") == 0);
+
+    char *optionFirst[] = {"app", "-c", "1", "a", "--", "-x"};
+    CHECK(ParseArgsInContext(&workspace, &context, 6, optionFirst));
+    CHECK(strcmp(context.optVals[0], "1") == 0);
+    CHECK(context.numOfRestVals == 2 && strcmp(context.restVals[0], "a") == 0 && strcmp(context.restVals[1], "-x") == 0);
+
+    char *optionLast[] = {"app", "a", "-c", "2", "--", "-x", "-y"};
+    CHECK(ParseArgsInContext(&workspace, &context, 7, optionLast));
+    CHECK(strcmp(context.optVals[0], "2") == 0);
+    CHECK(context.numOfRestVals == 3 && strcmp(context.restVals[0], "a") == 0 && strcmp(context.restVals[2], "-y") == 0);
+
+    char *interleaved[] = {"app", "a", "-c", "2", "b", "--", "-x"};
+    CHECK(!ParseArgsInContext(&workspace, &context, 7, interleaved));
+    CHECK(context.error.code == ERR_WRONG_SYNTAX);
+
+    DeleteParseContext(&context);
+    DeleteWorkspace(&workspace);
+
+    /* Non-optional arguments take the first values on whichever side of '--' they are */
+    ScmdpWorkspace copyWorkspace = AddWorkspace("USAGE: copy SOURCE TARGET [FILES...]", "Test of terminator");
+    char *source = NULL;
+    char *target = NULL;
+
+    AddNonOptArg(&copyWorkspace, "SOURCE", "Source", &source);
+    AddNonOptArg(&copyWorkspace, "TARGET", "Target", &target);
+    AddRestArg(&copyWorkspace, "FILES", "Files to copy", 0, -1, &files, &numOfFiles);
+    context = AddParseContext(&copyWorkspace);
+
+    char *split[] = {"copy", "src", "--", "-dst", "-f"};
+    CHECK(ParseArgsInContext(&copyWorkspace, &context, 5, split));
+    CHECK(strcmp(context.nonOptVals[0], "src") == 0 && strcmp(context.nonOptVals[1], "-dst") == 0);
+    CHECK(context.numOfRestVals == 1 && strcmp(context.restVals[0], "-f") == 0);
+
+    char *tooFew[] = {"copy", "src", "--"};
+    CHECK(!ParseArgsInContext(&copyWorkspace, &context, 3, tooFew));
+    CHECK(context.error.code == ERR_WRONG_PARS_NUMBER);
+
+    DeleteParseContext(&context);
+    DeleteWorkspace(&copyWorkspace);
+    printf("terminator: OK\n");
+    return 0;
+}
@@ -0,0 +1,591 @@
+/**
+ * scmdpgen - generator of specialized command-line parsers
+ *
+ * Reads a declarative spec describing the same data as AddWorkspace(), AddHelpArg(),
+ * AddOptArg() and AddNonOptArg() calls and emits a C source and header with a parser
+ * for exactly this set of arguments. Keys are matched by a switch over key length
+ * and memcmp(), values are written to typed fields of the generated structure
+ * and the whole help text is assembled at generation time.
+ *
+ * USAGE: scmdpgen SPEC OUT_C OUT_H NAME
+ *
+ * Spec is a list of lines (words may be quoted with "", '#' starts a comment):
+ *     workspace "SYNTAX HELP" "DESCRIPTION"
+ *     help --help -h
+ *     opt --option1 -op1 VALUE "Optional argument 1\nwith value"
+ *     opt --option2 -op2 "" "Optional argument 2\nwithout value"
+ *     nonopt arg1 "Neccessary argument 1"
+ *
+ * NAME prefixes generated names: NAMEArgs structure and NAMEParseArgs() function
+ */
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GEN_MAX_WORDS 8
+#define GEN_MAX_FIELD 64
+
+/* Optional argument read from spec */
+typedef struct
+{
+    char *longKey; /* Long parameter (ex.: --help) */
+    char *shortKey; /* Short parameter (ex.: -h) */
+    char *valName; /* The name of parameter's value, "" if it's non-valuable */
+    char *help; /* The string with parameter description */
+    char field[GEN_MAX_FIELD]; /* Name of field in generated structure */
+} GenOptArg;
+
+/* Non-optional argument read from spec */
+typedef struct
+{
+    char *key; /* The name of parameter (ex.: ARG1) */
+    char *help; /* Description of parameter */
+    char field[GEN_MAX_FIELD]; /* Name of field in generated structure */
+} GenNonOptArg;
+
+/* Growing string to assemble help text */
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+} GenText;
+
+/* Everything read from spec */
+typedef struct
+{
+    GenOptArg *optArgs;
+    GenNonOptArg *nonOptArgs;
+    int numOfOptArgs;
+    int numOfValOptArgs;
+    int numOfNonOptArgs;
+    char *longHelpKey;
+    char *shortHelpKey;
+    char *syntaxHelp;
+    char *descriptHelp;
+} GenSpec;
+
+/**
+ * @brief Splits the spec line into words in place. Quoted words may contain spaces and C escapes
+ *
+ * @returns Number of words or -1 if quotes are not closed
+ */
+int _SplitLine(char *line, char *words[])
+{
+    int numOfWords = 0;
+    char *write;
+
+    while (*line != '\0')
+    {
+        while (*line == ' ' || *line == '\t' || *line == '\r')
+        {
+            line++;
+        }
+        if (*line == '\0' || *line == '#' || numOfWords == GEN_MAX_WORDS)
+        {
+            break;
+        }
+
+        words[numOfWords++] = line;
+        if (*line == '"')
+        {
+            /* Unescape the quoted word in place, it never gets longer */
+            write = ++words[numOfWords-1];
+            line++;
+            while (*line != '"')
+            {
+                if (*line == '\0')
+                {
+                    return -1;
+                }
+                if (*line == '\\' && line[1] != '\0')
+                {
+                    line++;
+                    *write++ = (*line == 'n') ? '\n' : (*line == 't') ? '\t' : *line;
+                }
+                else
+                {
+                    *write++ = *line;
+                }
+                line++;
+            }
+            line++;
+            *write = '\0';
+            if (*line != '\0')
+            {
+                *line++ = '\0';
+            }
+        }
+        else
+        {
+            while (*line != '\0' && *line != ' ' && *line != '\t' && *line != '\r')
+            {
+                line++;
+            }
+            if (*line != '\0')
+            {
+                *line++ = '\0';
+            }
+        }
+    }
+    return numOfWords;
+}
+
+/**
+ * @brief Makes the C identifier from the key (ex.: --out-file -> out_file)
+ */
+void _MakeField(char *field, char *key)
+{
+    int length = 0;
+
+    while (*key == '-' || *key == '/')
+    {
+        key++;
+    }
+    if (isdigit((unsigned char)*key))
+    {
+        field[length++] = '_';
+    }
+    for (; *key != '\0' && length < GEN_MAX_FIELD - 1; key++)
+    {
+        field[length++] = isalnum((unsigned char)*key) ? *key : '_';
+    }
+    field[length] = '\0';
+}
+
+/**
+ * @brief Checks that no key is used twice, including keys of help. Keys are put
+ * into the open-addressing set with FNV-1a hash, so the check is linear
+ *
+ * @returns TRUE, if all keys are unique. Otherwise, FALSE.
+ */
+bool _CheckKeys(GenSpec *spec, char *path)
+{
+    int numOfSlots = 1;
+    char **slots;
+    char *key;
+    unsigned int hash;
+    bool success = true;
+
+    while (numOfSlots < 4 * spec->numOfOptArgs + 4)
+    {
+        numOfSlots <<= 1;
+    }
+    slots = calloc(numOfSlots, sizeof(char *));
+
+    for (int i = -1; i < spec->numOfOptArgs && success; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            key = (i < 0) ? (j == 0 ? spec->longHelpKey : spec->shortHelpKey) : (j == 0 ? spec->optArgs[i].longKey : spec->optArgs[i].shortKey);
+            if (key == NULL || *key == '\0' || (j == 1 && i >= 0 && strcmp(key, spec->optArgs[i].longKey) == 0))
+            {
+                continue;
+            }
+
+            hash = 2166136261u;
+            for (char *symbol = key; *symbol != '\0'; symbol++)
+            {
+                hash = (hash ^ (unsigned char)*symbol) * 16777619u;
+            }
+            hash &= numOfSlots - 1;
+            while (slots[hash] != NULL && strcmp(slots[hash], key) != 0)
+            {
+                hash = (hash + 1) & (numOfSlots - 1);
+            }
+            if (slots[hash] != NULL)
+            {
+                fprintf(stderr, "%s: key '%s' is used twice\n", path, key);
+                success = false;
+                break;
+            }
+            slots[hash] = key;
+        }
+    }
+    free(slots);
+    return success;
+}
+
+/**
+ * @brief Reads and checks the spec file
+ *
+ * @returns TRUE, if the spec is correct. Otherwise, FALSE.
+ */
+bool _ReadSpec(GenSpec *spec, char *path)
+{
+    FILE *file;
+    char *text, *line, *next;
+    char *words[GEN_MAX_WORDS];
+    long size;
+    int numOfWords;
+    int lineNumber = 0;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "scmdpgen: can't open %s\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    text = malloc(size + 1);
+    text[fread(text, 1, size, file)] = '\0';
+    fclose(file);
+
+    memset(spec, 0, sizeof(GenSpec));
+    spec->syntaxHelp = "";
+    spec->descriptHelp = "";
+
+    /* Strings of spec point into the text, so it's never released */
+    for (line = text; line != NULL; line = next)
+    {
+        lineNumber++;
+        next = strchr(line, '\n');
+        if (next != NULL)
+        {
+            *next++ = '\0';
+        }
+
+        numOfWords = _SplitLine(line, words);
+        if (numOfWords == 0)
+        {
+            continue;
+        }
+        if (numOfWords == 3 && strcmp(words[0], "workspace") == 0)
+        {
+            spec->syntaxHelp = words[1];
+            spec->descriptHelp = words[2];
+        }
+        else if (numOfWords == 3 && strcmp(words[0], "help") == 0)
+        {
+            spec->longHelpKey = words[1];
+            spec->shortHelpKey = words[2];
+        }
+        else if (numOfWords == 5 && strcmp(words[0], "opt") == 0)
+        {
+            spec->optArgs = realloc(spec->optArgs, sizeof(GenOptArg) * (spec->numOfOptArgs + 1));
+            spec->optArgs[spec->numOfOptArgs].longKey = words[1];
+            spec->optArgs[spec->numOfOptArgs].shortKey = words[2];
+            spec->optArgs[spec->numOfOptArgs].valName = words[3];
+            spec->optArgs[spec->numOfOptArgs].help = words[4];
+            _MakeField(spec->optArgs[spec->numOfOptArgs].field, (*words[1] != '\0') ? words[1] : words[2]);
+            if (*words[3] != '\0')
+            {
+                spec->numOfValOptArgs++;
+            }
+            spec->numOfOptArgs++;
+        }
+        else if (numOfWords == 3 && strcmp(words[0], "nonopt") == 0)
+        {
+            spec->nonOptArgs = realloc(spec->nonOptArgs, sizeof(GenNonOptArg) * (spec->numOfNonOptArgs + 1));
+            spec->nonOptArgs[spec->numOfNonOptArgs].key = words[1];
+            spec->nonOptArgs[spec->numOfNonOptArgs].help = words[2];
+            _MakeField(spec->nonOptArgs[spec->numOfNonOptArgs].field, words[1]);
+            spec->numOfNonOptArgs++;
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d: wrong spec line\n", path, lineNumber);
+            return false;
+        }
+    }
+
+    /* Fields share one structure, so their names must be unique */
+    for (int i = 0; i < spec->numOfOptArgs + spec->numOfNonOptArgs; i++)
+    {
+        char *field = (i < spec->numOfOptArgs) ? spec->optArgs[i].field : spec->nonOptArgs[i - spec->numOfOptArgs].field;
+        for (int j = 0; j < i; j++)
+        {
+            char *other = (j < spec->numOfOptArgs) ? spec->optArgs[j].field : spec->nonOptArgs[j - spec->numOfOptArgs].field;
+            if (*field == '\0' || strcmp(field, other) == 0)
+            {
+                fprintf(stderr, "%s: argument '%s' gives empty or duplicate field name\n", path, field);
+                return false;
+            }
+        }
+    }
+    return _CheckKeys(spec, path);
+}
+
+/**
+ * @brief Appends formatted string to the text
+ */
+void _AppendText(GenText *text, const char *format, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (text->length + length + 1 > text->capacity)
+    {
+        text->capacity = (text->length + length + 1) * 2;
+        text->data = realloc(text->data, text->capacity);
+    }
+    va_start(args, format);
+    vsnprintf(text->data + text->length, length + 1, format, args);
+    va_end(args);
+    text->length += length;
+}
+
+/**
+ * @brief Appends the description with indentation of every new line (the same as _ShowHelp())
+ */
+void _AppendIndented(GenText *text, char *help, int indent)
+{
+    for (; *help != '\0'; help++)
+    {
+        if (*help == '\n')
+        {
+            _AppendText(text, "\n%-*s", indent, " ");
+        }
+        else
+        {
+            _AppendText(text, "%c", *help);
+        }
+    }
+}
+
+/**
+ * @brief Writes the string as C literal, splitting it at new lines
+ */
+void _WriteLiteral(FILE *file, const char *string)
+{
+    fputc('"', file);
+    for (; *string != '\0'; string++)
+    {
+        switch (*string)
+        {
+        case '\n':
+            fputs((string[1] != '\0') ? "\\n\"\n    \"" : "\\n", file);
+            break;
+        case '\t':
+            fputs("\\t", file);
+            break;
+        case '"':
+            fputs("\\\"", file);
+            break;
+        case '\\':
+            fputs("\\\\", file);
+            break;
+        default:
+            fputc(*string, file);
+            break;
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief Writes the key matcher: a switch over key length and memcmp() for the keys of that length
+ */
+void _WriteMatcher(FILE *file, GenSpec *spec, char *name)
+{
+    int maxLength = 0;
+    int length;
+    char *key;
+    bool caseOpened;
+
+    for (int i = -1; i < spec->numOfOptArgs; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            key = (i < 0) ? (j == 0 ? spec->longHelpKey : spec->shortHelpKey) : (j == 0 ? spec->optArgs[i].longKey : spec->optArgs[i].shortKey);
+            if (key != NULL && (int)strlen(key) > maxLength)
+            {
+                maxLength = (int)strlen(key);
+            }
+        }
+    }
+
+    fprintf(file, "static int %sMatchKey(const char *key)\n{\n    switch (strlen(key))\n    {\n", name);
+    for (length = 1; length <= maxLength; length++)
+    {
+        caseOpened = false;
+        for (int i = -1; i < spec->numOfOptArgs; i++)
+        {
+            for (int j = 0; j < 2; j++)
+            {
+                key = (i < 0) ? (j == 0 ? spec->longHelpKey : spec->shortHelpKey) : (j == 0 ? spec->optArgs[i].longKey : spec->optArgs[i].shortKey);
+                if (key == NULL || (int)strlen(key) != length)
+                {
+                    continue;
+                }
+                if (!caseOpened)
+                {
+                    fprintf(file, "    case %d:\n", length);
+                    caseOpened = true;
+                }
+                fprintf(file, "        if (memcmp(key, ");
+                _WriteLiteral(file, key);
+                if (i < 0)
+                {
+                    fprintf(file, ", %d) == 0) return %s_HELP_ID;\n", length, name);
+                }
+                else
+                {
+                    fprintf(file, ", %d) == 0) return %d;\n", length, i);
+                }
+            }
+        }
+        if (caseOpened)
+        {
+            fprintf(file, "        break;\n");
+        }
+    }
+    fprintf(file, "    default:\n        break;\n    }\n    return %s_UNKNOWN_ID;\n}\n\n", name);
+}
+
+/**
+ * @brief Writes the header with structure of values and parser declaration
+ */
+void _WriteHeader(FILE *file, GenSpec *spec, char *name)
+{
+    fprintf(file, "/* Generated by scmdpgen, don't edit */\n");
+    fprintf(file, "#ifndef H_%s_ARGS\n#define H_%s_ARGS\n\n#include <stdbool.h>\n\n", name, name);
+    fprintf(file, "/* Values of arguments. Fields of absent optional arguments are not changed */\ntypedef struct\n{\n");
+    for (int i = 0; i < spec->numOfOptArgs; i++)
+    {
+        if (*spec->optArgs[i].valName != '\0')
+        {
+            fprintf(file, "    char *%s; /* %s %s */\n", spec->optArgs[i].field, spec->optArgs[i].longKey, spec->optArgs[i].valName);
+        }
+        else
+        {
+            fprintf(file, "    bool %s; /* %s */\n", spec->optArgs[i].field, spec->optArgs[i].longKey);
+        }
+    }
+    for (int i = 0; i < spec->numOfNonOptArgs; i++)
+    {
+        fprintf(file, "    char *%s; /* %s */\n", spec->nonOptArgs[i].field, spec->nonOptArgs[i].key);
+    }
+    fprintf(file, "} %sArgs;\n\n", name);
+    fprintf(file, "/**\n * @brief Parses the entered arguments into the structure, behaves as ParseArgs() of scmdp\n"
+                  " *\n * @return TRUE, if the parsing was successful. Otherwise, FALSE.\n*/\n");
+    fprintf(file, "bool %sParseArgs(%sArgs *args, int argc, char *argv[]);\n\n#endif\n", name, name);
+}
+
+/**
+ * @brief Writes the source with help text, key matcher and parser
+ */
+void _WriteSource(FILE *file, GenSpec *spec, char *name, char *headerName)
+{
+    GenText fullHelp = {NULL, 0, 0};
+
+    /* The same layout as _ShowHelp() prints */
+    _AppendText(&fullHelp, "%s\n\n%s\n", spec->syntaxHelp, spec->descriptHelp);
+    _AppendText(&fullHelp, "\n>> Non-optional arguments:\n");
+    for (int i = 0; i < spec->numOfNonOptArgs; i++)
+    {
+        _AppendText(&fullHelp, "\n%3s%-10s", " ", spec->nonOptArgs[i].key);
+        _AppendIndented(&fullHelp, spec->nonOptArgs[i].help, 13);
+    }
+    _AppendText(&fullHelp, "\n\n>> Optional agruments:\n");
+    for (int i = 0; i < spec->numOfOptArgs; i++)
+    {
+        _AppendText(&fullHelp, "\n%3s%-10s,%-5s%-7s", " ", spec->optArgs[i].longKey, spec->optArgs[i].shortKey, spec->optArgs[i].valName);
+        _AppendIndented(&fullHelp, spec->optArgs[i].help, 26);
+    }
+
+    fprintf(file, "/* Generated by scmdpgen, don't edit */\n#include \"%s\"\n\n#include <stdio.h>\n#include <string.h>\n\n", headerName);
+    fprintf(file, "#define %s_HELP_ID -1\n#define %s_UNKNOWN_ID -2\n#define %s_IS_OPT(arg) (*(arg) == '-' || *(arg) == '/')\n\n", name, name, name);
+    fprintf(file, "static const char %sSyntaxHelp[] = ", name);
+    _WriteLiteral(file, spec->syntaxHelp);
+    fprintf(file, ";\n\nstatic const char %sFullHelp[] =\n    ", name);
+    _WriteLiteral(file, fullHelp.data != NULL ? fullHelp.data : "");
+    fprintf(file, ";\n\n");
+    free(fullHelp.data);
+
+    _WriteMatcher(file, spec, name);
+
+    fprintf(file, "static bool %sShowError(const char *error)\n{\n"
+                  "    printf(\"%%s\\nprint -h or --help to see help\\n\", error);\n    return false;\n}\n\n", name);
+
+    fprintf(file, "bool %sParseArgs(%sArgs *args, int argc, char *argv[])\n{\n", name, name);
+    fprintf(file, "    int numOfNonOptArgs = %d;\n    int first, last, id;\n    bool optionFirst;\n\n", spec->numOfNonOptArgs);
+    if (spec->longHelpKey != NULL)
+    {
+        fprintf(file, "    for (int i = 1; i < argc; i++)\n    {\n        if (%sMatchKey(argv[i]) == %s_HELP_ID)\n        {\n"
+                      "            fputs(%sFullHelp, stdout);\n            return false;\n        }\n    }\n", name, name, name);
+    }
+    fprintf(file, "    if (argc - 1 > %d || argc - 1 < numOfNonOptArgs)\n    {\n        printf(\"%%s\\n\", %sSyntaxHelp);\n        return false;\n    }\n\n",
+            spec->numOfNonOptArgs + spec->numOfOptArgs + spec->numOfValOptArgs, name);
+
+    /* Non-optional arguments take the end of command line if it starts with an option, otherwise the beginning */
+    fprintf(file, "    optionFirst = (argc > 1 && %s_IS_OPT(argv[1]));\n    first = optionFirst ? argc - numOfNonOptArgs : 1;\n", name);
+    fprintf(file, "    for (int i = 0; i < numOfNonOptArgs; i++)\n    {\n        if (%s_IS_OPT(argv[first + i]))\n        {\n"
+                  "            return %sShowError(\"Error: Need a value for non-optional parameter!\");\n        }\n", name, name);
+    if (spec->numOfNonOptArgs > 0)
+    {
+        fprintf(file, "        switch (i)\n        {\n");
+        for (int i = 0; i < spec->numOfNonOptArgs; i++)
+        {
+            fprintf(file, "        case %d:\n            args->%s = argv[first + i];\n            break;\n", i, spec->nonOptArgs[i].field);
+        }
+        fprintf(file, "        default:\n            break;\n        }\n");
+    }
+    fprintf(file, "    }\n\n");
+
+    fprintf(file, "    first = optionFirst ? 1 : numOfNonOptArgs + 1;\n    last = optionFirst ? argc - numOfNonOptArgs : argc;\n");
+    fprintf(file, "    for (int i = first; i < last; i++)\n    {\n");
+    fprintf(file, "        if (optionFirst && !%s_IS_OPT(argv[i]))\n        {\n"
+                  "            return %sShowError(\"Error: Wrong command line syntax!\");\n        }\n", name, name);
+    fprintf(file, "        id = %sMatchKey(argv[i]);\n        switch (id)\n        {\n", name);
+    for (int i = 0; i < spec->numOfOptArgs; i++)
+    {
+        fprintf(file, "        case %d:\n", i);
+        if (*spec->optArgs[i].valName != '\0')
+        {
+            fprintf(file, "            if (i + 1 >= last || %s_IS_OPT(argv[i+1]))\n            {\n"
+                          "                return %sShowError(\"Error: Need a value for optional parameter!\");\n            }\n", name, name);
+            fprintf(file, "            args->%s = argv[++i];\n", spec->optArgs[i].field);
+        }
+        else
+        {
+            fprintf(file, "            args->%s = true;\n", spec->optArgs[i].field);
+        }
+        fprintf(file, "            break;\n");
+    }
+    fprintf(file, "        default:\n            return %sShowError(\"Error: Unknown argument or option!\");\n        }\n    }\n", name);
+    fprintf(file, "    return true;\n}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    GenSpec spec;
+    FILE *source, *header;
+    char *headerName;
+
+    if (argc != 5)
+    {
+        printf("USAGE: scmdpgen SPEC OUT_C OUT_H NAME\n");
+        return 1;
+    }
+    if (!_ReadSpec(&spec, argv[1]))
+    {
+        return 1;
+    }
+
+    /* The source includes the header by its file name, both are generated in the same folder */
+    headerName = strrchr(argv[3], '/');
+    headerName = (headerName != NULL) ? headerName + 1 : argv[3];
+
+    source = fopen(argv[2], "w");
+    header = fopen(argv[3], "w");
+    if (source == NULL || header == NULL)
+    {
+        fprintf(stderr, "scmdpgen: can't write output files\n");
+        return 1;
+    }
+    _WriteHeader(header, &spec, argv[4]);
+    _WriteSource(source, &spec, argv[4], headerName);
+    fclose(header);
+    fclose(source);
+    return 0;
+}